@@ -23,8 +23,13 @@ SOFTWARE.
 */
 #pragma once
 
+#include <cstddef>
 #include <utility>
 #include <type_traits>
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+#include <compare>
+#define STRONG_ALIAS_THREE_WAY_COMPARISON 1
+#endif
 
 // Macro for conveniently defining a new alias
 #define ALIAS(NAME, ...) \
@@ -39,6 +44,17 @@ namespace strong
     template<typename Name>
     struct alias_name {};
 
+    namespace detail
+    {
+        // Alias arguments are compared as their underlying type, anything else as is
+        template<typename T, typename Arg>
+        constexpr decltype(auto) unwrap(const Arg& arg) noexcept
+        {
+            if constexpr (std::is_base_of_v<is_alias, Arg>) return static_cast<const T&>(arg);
+            else return (arg);
+        }
+    }
+
     template <typename T, typename Name, typename = void>
     struct alias;
 
@@ -109,6 +125,10 @@ namespace strong
         bool operator > (const Arg& arg) const = delete;
         template<typename Arg, typename = std::enable_if_t<is_different_alias_v<Arg>>>
         bool operator < (const Arg& arg) const = delete;
+#ifdef STRONG_ALIAS_THREE_WAY_COMPARISON
+        template<typename Arg, typename = std::enable_if_t<is_different_alias_v<Arg>>>
+        void operator<=>(const Arg& arg) const = delete;
+#endif
         // Logical operators
         template<typename Arg, typename = std::enable_if_t<is_different_alias_v<Arg>>>
         bool operator &&(const Arg& arg) const = delete;
@@ -164,23 +184,60 @@ namespace strong
         constexpr alias& operator>>=(const Arg& arg) { return static_cast<alias&>(T::operator>>=(arg)); }
         // Comparison operators
         template<typename Arg, typename = std::enable_if_t<!is_different_alias_v<Arg>>>
-        bool operator ==(const Arg& arg) const { return T::operator==(arg); }
+        bool operator ==(const Arg& arg) const { return static_cast<const T&>(*this) == detail::unwrap<T>(arg); }
         template<typename Arg, typename = std::enable_if_t<!is_different_alias_v<Arg>>>
-        bool operator !=(const Arg& arg) const { return T::operator!=(arg); }
+        bool operator !=(const Arg& arg) const { return static_cast<const T&>(*this) != detail::unwrap<T>(arg); }
         template<typename Arg, typename = std::enable_if_t<!is_different_alias_v<Arg>>>
-        bool operator >=(const Arg& arg) const { return T::operator>=(arg); }
+        bool operator >=(const Arg& arg) const { return static_cast<const T&>(*this) >= detail::unwrap<T>(arg); }
         template<typename Arg, typename = std::enable_if_t<!is_different_alias_v<Arg>>>
-        bool operator <=(const Arg& arg) const { return T::operator<=(arg); }
+        bool operator <=(const Arg& arg) const { return static_cast<const T&>(*this) <= detail::unwrap<T>(arg); }
         template<typename Arg, typename = std::enable_if_t<!is_different_alias_v<Arg>>>
-        bool operator > (const Arg& arg) const { return T::operator>(arg); }
+        bool operator > (const Arg& arg) const { return static_cast<const T&>(*this) > detail::unwrap<T>(arg); }
         template<typename Arg, typename = std::enable_if_t<!is_different_alias_v<Arg>>>
-        bool operator < (const Arg& arg) const { return T::operator<(arg); }
+        bool operator < (const Arg& arg) const { return static_cast<const T&>(*this) < detail::unwrap<T>(arg); }
+#ifdef STRONG_ALIAS_THREE_WAY_COMPARISON
+        template<typename Arg, typename = std::enable_if_t<!is_different_alias_v<Arg>>>
+        auto operator<=>(const Arg& arg) const -> decltype(std::declval<const T&>() <=> detail::unwrap<T>(arg)) { return static_cast<const T&>(*this) <=> detail::unwrap<T>(arg); }
+#endif
+        // Non-member operators of T would accept a different alias through its base, unless deleted here
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator ==(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator !=(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator >=(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator <=(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator > (const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator < (const Arg& arg) const = delete;
+#ifdef STRONG_ALIAS_THREE_WAY_COMPARISON
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        void operator<=>(const Arg& arg) const = delete;
+#endif
         // Logical operators
         template<typename Arg, typename = std::enable_if_t<!is_different_alias_v<Arg>>>
         bool operator &&(const Arg& arg) const { return T::operator&&(arg); }
         template<typename Arg, typename = std::enable_if_t<!is_different_alias_v<Arg>>>
         bool operator ||(const Arg& arg) const { return T::operator||(arg); }
     };
+
+    // Traits usable outside of the alias definitions
+    template<typename Arg> inline constexpr bool is_alias_v = std::is_base_of_v<is_alias, std::decay_t<Arg>>;
+
+    namespace detail
+    {
+        template<typename T, typename Name> T    underlying_of(const alias<T, Name>&);
+        template<typename T, typename Name> Name name_of(const alias<T, Name>&);
+    }
+    // Aliased type of an alias, e.g. int for ALIAS(A, int)
+    template<typename Alias> using underlying_t = decltype(detail::underlying_of(std::declval<const Alias&>()));
+    // Name of an alias, i.e. the type declared by the ALIAS macro
+    template<typename Alias> using name_t = decltype(detail::name_of(std::declval<const Alias&>()));
+
+    // Cache line size used to pad storage shared between threads
+    inline constexpr std::size_t cache_line_size = 64;
 }
 
 
@@ -194,6 +251,9 @@ ALIAS(B, std::int32_t);
 #include<vector>
 ALIAS(C, std::vector<double>*);
 ALIAS(D, int*);
+#include<string>
+ALIAS(S, std::string);
+ALIAS(T, std::string);
 
 int main()
 {
@@ -218,6 +278,8 @@ int main()
     { A a; [](B)  {} (a); }                 // ❌
     { A a; [](B&) {} (a); }                 // ❌
     { A a; [](B&&){} (std::move(a)); }      // ❌
+    { A a; A b; a <=> b; }                  // ✔️ C++20
+    { A a; B b; a <=> b; }                  // ❌
 
     /// Pointer fundamental type alias
     /////////////////////////////////////////////
@@ -258,6 +320,15 @@ int main()
     { X a; [](Y&) {} (a); }                 // ❌
     { X a; [](Y&&){} (std::move(a)); }      // ❌
 
+    ///// Class type alias with non-member operators
+    /////////////////////////////////////////////
+    { S a; S b; a < b; }                    // ✔️
+    { S a; S b; a == b; }                   // ✔️
+    { S a; a == "text"; }                   // ✔️
+    { S a; S b; a <=> b; }                  // ✔️ C++20
+    { S a; T b; a < b; }                    // ❌
+    { S a; T b; a <=> b; }                  // ❌
+
     return 0;
 }
 #endif
@@ -0,0 +1,266 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Macro for defining a class alias whose standard allocators are replaced by allocators tagged with the alias name
+#define TAGGED_ALIAS(NAME, ...) ALIAS(NAME, strong::tagged_t<NAME, __VA_ARGS__>)
+
+namespace strong
+{
+    // Allocation counters of one tag
+    struct memory_stats
+    {
+        std::uint64_t allocations       = 0;
+        std::uint64_t deallocations     = 0;
+        std::uint64_t bytes_allocated   = 0;
+        std::uint64_t bytes_deallocated = 0;
+
+        std::uint64_t live_bytes() const noexcept { return bytes_allocated - bytes_deallocated; }
+        memory_stats& operator+=(const memory_stats& other) noexcept
+        {
+            allocations       += other.allocations;
+            deallocations     += other.deallocations;
+            bytes_allocated   += other.bytes_allocated;
+            bytes_deallocated += other.bytes_deallocated;
+            return *this;
+        }
+    };
+
+    namespace detail
+    {
+        // Unqualified-ish name of a type, extracted from the compiler's function signature
+        template<typename Name>
+        std::string_view type_name() noexcept
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            std::string_view signature = __FUNCSIG__;
+            signature = signature.substr(signature.find("type_name<") + 10);
+            signature = signature.substr(0, signature.rfind(">(void)"));
+            for (std::string_view prefix : { "struct ", "class " })
+                if (signature.substr(0, prefix.size()) == prefix)
+                    signature.remove_prefix(prefix.size());
+            return signature;
+#else
+            std::string_view signature = __PRETTY_FUNCTION__;
+            signature = signature.substr(signature.find("Name = ") + 7);
+            return signature.substr(0, signature.find_first_of(";]"));
+#endif
+        }
+
+        // Counters written by a single thread, or by any thread when shared, and read by reporting threads
+        struct memory_counters
+        {
+            std::atomic<std::uint64_t> allocations{ 0 }, deallocations{ 0 }, bytes_allocated{ 0 }, bytes_deallocated{ 0 };
+            bool shared;
+
+            constexpr explicit memory_counters(bool shared = false) noexcept : shared{ shared } {}
+
+            void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n) noexcept
+            {
+                if (shared)
+                    counter.fetch_add(n, std::memory_order_relaxed);
+                else
+                    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+            }
+            memory_stats load() const noexcept
+            {
+                return { allocations.load(std::memory_order_relaxed), deallocations.load(std::memory_order_relaxed),
+                         bytes_allocated.load(std::memory_order_relaxed), bytes_deallocated.load(std::memory_order_relaxed) };
+            }
+        };
+
+        struct memory_tag
+        {
+            std::string_view name;
+            memory_stats(*snapshot)();
+        };
+        inline std::mutex& memory_tags_mutex() { static std::mutex mutex; return mutex; }
+        inline std::vector<memory_tag>& memory_tags() { static std::vector<memory_tag> tags; return tags; }
+
+        // Per-thread counters of an alias name, merged on snapshot or when their thread exits
+        template<typename Tag>
+        class memory_registry;
+        template<typename Name>
+        class memory_registry<alias_name<Name>>
+        {
+            struct thread_counters : memory_counters
+            {
+                thread_counters()
+                {
+                    memory_registry& registry = instance();
+                    std::lock_guard<std::mutex> lock{ registry.mutex_ };
+                    registry.threads_.push_back(this);
+                }
+                ~thread_counters()
+                {
+                    memory_registry& registry = instance();
+                    std::lock_guard<std::mutex> lock{ registry.mutex_ };
+                    registry.retired_ += load();
+                    registry.threads_.erase(std::find(registry.threads_.begin(), registry.threads_.end(), this));
+                    retired() = true;
+                }
+            };
+
+            // Neither has a destructor, so both stay usable from destructors running after the thread's counters are gone
+            static bool& retired() { static thread_local bool flag = false; return flag; }
+            static memory_counters& orphaned() { static memory_counters counters{ true }; return counters; }
+
+            memory_registry()
+            {
+                std::lock_guard<std::mutex> lock{ memory_tags_mutex() };
+                memory_tags().push_back({ type_name<Name>(), &snapshot });
+            }
+
+            static memory_registry& instance() { static memory_registry registry; return registry; }
+
+            std::mutex                           mutex_;
+            std::vector<const memory_counters*>  threads_;
+            memory_stats                         retired_;
+
+        public:
+            // Counters of the calling thread, or the process-wide ones once they have been destroyed:
+            // static objects using a tagged allocator, for example, free their memory after the main thread's thread_locals.
+            static memory_counters& local()
+            {
+                if (retired())
+                    return orphaned();
+                static thread_local thread_counters counters;
+                return counters;
+            }
+            static memory_stats snapshot()
+            {
+                memory_registry& registry = instance();
+                std::lock_guard<std::mutex> lock{ registry.mutex_ };
+                memory_stats total = registry.retired_;
+                total += orphaned().load();
+                for (const memory_counters* counters : registry.threads_)
+                    total += counters->load();
+                return total;
+            }
+        };
+    }
+
+    // Standard allocator recording its allocations under the alias Name
+    template<typename T, typename Name>
+    class tagged_allocator
+    {
+        using registry = detail::memory_registry<alias_name<Name>>;
+
+    public:
+        using value_type = T;
+        template<typename U> struct rebind { using other = tagged_allocator<U, Name>; };
+
+        tagged_allocator() noexcept = default;
+        template<typename U>
+        tagged_allocator(const tagged_allocator<U, Name>&) noexcept {}
+
+        T* allocate(std::size_t n)
+        {
+            T* p = std::allocator<T>{}.allocate(n);
+            detail::memory_counters& counters = registry::local();
+            counters.bump(counters.allocations, 1);
+            counters.bump(counters.bytes_allocated, n * sizeof(T));
+            return p;
+        }
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            std::allocator<T>{}.deallocate(p, n);
+            detail::memory_counters& counters = registry::local();
+            counters.bump(counters.deallocations, 1);
+            counters.bump(counters.bytes_deallocated, n * sizeof(T));
+        }
+
+        template<typename U> bool operator==(const tagged_allocator<U, Name>&) const noexcept { return true; }
+        template<typename U> bool operator!=(const tagged_allocator<U, Name>&) const noexcept { return false; }
+    };
+
+    namespace detail
+    {
+        // Replace every std::allocator found in the template arguments of T, recursively
+        template<typename Name, typename T>
+        struct tagged { using type = T; };
+        template<typename Name, typename T>
+        struct tagged<Name, std::allocator<T>> { using type = tagged_allocator<typename tagged<Name, T>::type, Name>; };
+        template<typename Name, template<typename...> class Template, typename... Args>
+        struct tagged<Name, Template<Args...>> { using type = Template<typename tagged<Name, Args>::type...>; };
+        template<typename Name, typename T>
+        struct tagged<Name, const T> { using type = const typename tagged<Name, T>::type; };
+    }
+    template<typename Name, typename T> using tagged_t = typename detail::tagged<Name, T>::type;
+
+    // Counters of a single alias name, summed over all threads
+    template<typename Name>
+    memory_stats memory_usage() { return detail::memory_registry<alias_name<Name>>::snapshot(); }
+
+    // Counters of every alias name that allocated so far
+    inline std::vector<std::pair<std::string_view, memory_stats>> memory_report()
+    {
+        std::vector<detail::memory_tag> tags;
+        {
+            std::lock_guard<std::mutex> lock{ detail::memory_tags_mutex() };
+            tags = detail::memory_tags();
+        }
+        std::vector<std::pair<std::string_view, memory_stats>> report;
+        for (const detail::memory_tag& tag : tags)
+            report.emplace_back(tag.name, tag.snapshot());
+        return report;
+    }
+}
+
+
+#ifdef STRONG_ALLOCATOR_TEST
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+TAGGED_ALIAS(Payload, std::vector<std::byte>);
+TAGGED_ALIAS(IndexBlock, std::map<int, std::vector<int>>);
+ALIAS(Cache, std::vector<int, strong::tagged_allocator<int, struct Cache>>);
+TAGGED_ALIAS(Other, std::vector<std::byte>);
+
+int main()
+{
+    { Payload p(128); p.push_back(std::byte{ 1 }); }                                  // ✔️
+    { IndexBlock b; b[0].resize(16); }                                               // ✔️
+    { Cache c(4); }                                                                  // ✔️
+    { strong::memory_stats s = strong::memory_usage<Payload>(); s.live_bytes(); }    // ✔️
+    { for (auto& [name, stats] : strong::memory_report()) { name.size(); stats.allocations; } } // ✔️
+    { Payload p; Other o; p = o; }                                                   // ❌
+    { Payload p; std::vector<std::byte> v = p; }                                     // ❌
+
+    return 0;
+}
+#endif
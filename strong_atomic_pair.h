@@ -0,0 +1,188 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#if (defined(__GNUC__) && defined(__x86_64__)) || (defined(_MSC_VER) && defined(_M_X64))
+#define STRONG_HAS_CMPXCHG16B 1
+#else
+#define STRONG_HAS_CMPXCHG16B 0
+#endif
+
+namespace strong
+{
+    namespace detail
+    {
+#if STRONG_HAS_CMPXCHG16B
+        // 128-bit compare-and-swap, expected is updated with the current value on failure
+        inline bool cas128(std::uint64_t (&target)[2], std::uint64_t (&expected)[2], const std::uint64_t (&desired)[2]) noexcept
+        {
+#if defined(_MSC_VER)
+            return _InterlockedCompareExchange128(reinterpret_cast<volatile long long*>(target), static_cast<long long>(desired[1]), static_cast<long long>(desired[0]), reinterpret_cast<long long*>(expected));
+#else
+            bool success;
+            __asm__ __volatile__("lock cmpxchg16b %1"
+                : "=@ccz"(success), "+m"(target), "+a"(expected[0]), "+d"(expected[1])
+                : "b"(desired[0]), "c"(desired[1])
+                : "memory");
+            return success;
+#endif
+        }
+#endif
+    }
+
+    // Two scalar aliases updated together as a single 128-bit atomic
+    template<typename First, typename Second>
+    class atomic_pair
+    {
+        static_assert(is_alias_v<First> && is_alias_v<Second>, "atomic_pair members must be strong aliases");
+        static_assert(std::is_trivially_copyable_v<First> && std::is_trivially_copyable_v<Second>, "atomic_pair members must be trivially copyable");
+        static_assert(sizeof(First) <= sizeof(std::uint64_t) && sizeof(Second) <= sizeof(std::uint64_t), "atomic_pair members must fit in 64 bits");
+
+        using words = std::uint64_t[2];
+
+    public:
+        // Aggregate so that members are copy-initialized and only accept their own alias
+        struct value_type
+        {
+            First  first;
+            Second second;
+        };
+
+        static inline constexpr bool is_always_lock_free = STRONG_HAS_CMPXCHG16B;
+
+        atomic_pair() noexcept : atomic_pair(value_type{ First{}, Second{} }) {}
+        explicit atomic_pair(const value_type& value) noexcept { pack(value, words_); }
+        atomic_pair(const atomic_pair&) = delete;
+        atomic_pair& operator=(const atomic_pair&) = delete;
+
+        value_type load() const noexcept
+        {
+#if STRONG_HAS_CMPXCHG16B
+            // A failing or identity CAS returns the current value
+            words current{};
+            detail::cas128(words_, current, current);
+            return unpack(current);
+#else
+            guard lock{ lock_ };
+            return unpack(words_);
+#endif
+        }
+
+        void store(const value_type& value) noexcept
+        {
+            value_type expected = load();
+            while (!compare_exchange(expected, value)) {}
+        }
+
+        value_type exchange(const value_type& value) noexcept
+        {
+            value_type expected = load();
+            while (!compare_exchange(expected, value)) {}
+            return expected;
+        }
+
+        // Replace both members if they are bitwise equal to expected, otherwise load them into expected
+        bool compare_exchange(value_type& expected, const value_type& desired) noexcept
+        {
+            words before, after;
+            pack(expected, before);
+            pack(desired, after);
+#if STRONG_HAS_CMPXCHG16B
+            const bool success = detail::cas128(words_, before, after);
+#else
+            guard lock{ lock_ };
+            const bool success = std::memcmp(words_, before, sizeof(words)) == 0;
+            std::memcpy(success ? words_ : before, success ? after : words_, sizeof(words));
+#endif
+            if (!success)
+                expected = unpack(before);
+            return success;
+        }
+
+    private:
+        static void pack(const value_type& value, words& out) noexcept
+        {
+            out[0] = out[1] = 0;
+            std::memcpy(&out[0], static_cast<const void*>(&value.first), sizeof(First));
+            std::memcpy(&out[1], static_cast<const void*>(&value.second), sizeof(Second));
+        }
+        static value_type unpack(const words& in) noexcept
+        {
+            value_type value{ First{}, Second{} };
+            std::memcpy(static_cast<void*>(&value.first), &in[0], sizeof(First));
+            std::memcpy(static_cast<void*>(&value.second), &in[1], sizeof(Second));
+            return value;
+        }
+
+#if STRONG_HAS_CMPXCHG16B
+        alignas(16) mutable words words_;
+#else
+        struct guard
+        {
+            explicit guard(std::atomic_flag& flag) noexcept : flag_{ flag } { while (flag_.test_and_set(std::memory_order_acquire)) {} }
+            ~guard() { flag_.clear(std::memory_order_release); }
+            std::atomic_flag& flag_;
+        };
+        words                    words_;
+        mutable std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+#endif
+    };
+}
+
+
+#ifdef STRONG_ATOMIC_PAIR_TEST
+#include <cstdint>
+ALIAS(Head, std::uint32_t);
+ALIAS(Tag, std::uint64_t);
+ALIAS(Price, double);
+ALIAS(Qty, std::int64_t);
+#include <string>
+ALIAS(Name, std::string);
+
+int main()
+{
+    using book = strong::atomic_pair<Price, Qty>;
+    { book b; book::value_type v = b.load(); }                                  // ✔️
+    { book b; Price p = b.load().first; Qty q = b.load().second; }              // ✔️
+    { book b; b.store({ Price{ 1.5 }, Qty{ 10 } }); }                          // ✔️
+    { book b; b.store({ 1.5, 10 }); }                                          // ✔️
+    { book b; auto e = b.load(); b.compare_exchange(e, { e.first, e.second + 1 }); } // ✔️
+    { strong::atomic_pair<Head, Tag> h; h.exchange({ 0u, 1u }); }             // ✔️
+    { strong::atomic_pair<double, Qty> b; }                                    // ❌
+    { strong::atomic_pair<Name, Qty> b; }                                      // ❌
+    { book b; b.store({ Qty{ 10 }, Price{ 1.5 } }); }                          // ❌
+    { book b; Qty q = b.load().first; }                                        // ❌
+    { book b; auto e = b.load(); b.compare_exchange(e, { e.second, e.first }); } // ❌
+
+    return 0;
+}
+#endif
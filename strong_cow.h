@@ -0,0 +1,199 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+// Macro for conveniently defining a new copy-on-write alias
+#define COW_ALIAS(NAME, ...) \
+struct NAME final : strong::cow<NAME, __VA_ARGS__> \
+{\
+	using strong::cow<NAME, __VA_ARGS__>::cow;\
+}
+
+namespace strong
+{
+    namespace detail
+    {
+        // Reference counted value, shared by copy-on-write aliases of any name
+        template<typename T>
+        struct cow_block
+        {
+            template<typename... Args>
+            explicit cow_block(Args&&... args) : value(std::forward<Args>(args)...) {}
+            std::atomic<std::size_t> references{ 1 };
+            T                        value;
+        };
+    }
+
+    // Alias of a class type whose copies share one reference counted value until one of them is mutated
+    // Reads never copy, even through a non-const instance; writes go through mutate(), which first detaches a shared value.
+    // The reference returned by mutate() is only for writing before the next copy: once copied, writes through it show in the copy too.
+    template<typename Name, typename T>
+    class cow : public is_alias, public alias_name<Name>
+    {
+        template<typename, typename> friend class cow;
+
+        template<typename Arg> static inline constexpr bool is_different_alias_v =
+            is_alias_v<Arg> && !std::is_base_of_v<alias_name<Name>, std::decay_t<Arg>>;
+
+        using block = detail::cow_block<T>;
+
+        template<typename Arg>
+        bool same(const Arg& arg) const noexcept
+        {
+            if constexpr (std::is_base_of_v<cow, Arg>) return block_ && block_ == arg.block_;
+            else return false;
+        }
+        template<typename Arg>
+        static const auto& value_of(const Arg& arg) noexcept
+        {
+            if constexpr (std::is_base_of_v<cow, Arg>) return arg.get();
+            else return arg;
+        }
+
+    public:
+        // Default constructed and moved-from instances refer to a shared empty value without allocating
+        constexpr cow() noexcept = default;
+        template<typename... Args, typename = std::enable_if_t<(sizeof...(Args) > 1) || (!is_alias_v<Args> && ...)>>
+        explicit cow(Args&&... args) : block_{ new block(std::forward<Args>(args)...) } {}
+        template<typename Arg, typename = std::enable_if_t<!is_alias_v<Arg> && std::is_convertible_v<Arg&&, T>>>
+        cow(Arg&& value) : block_{ new block(std::forward<Arg>(value)) } {}
+        // Explicit conversion from another copy-on-write alias of the same type shares its value
+        template<typename OtherName, typename = std::enable_if_t<!std::is_same_v<OtherName, Name>>>
+        explicit cow(const cow<OtherName, T>& other) noexcept : block_{ acquire(other.block_) } {}
+
+        cow(const cow& other) noexcept : block_{ acquire(other.block_) } {}
+        cow(cow&& other) noexcept : block_{ std::exchange(other.block_, nullptr) } {}
+        cow& operator=(const cow& other) noexcept { cow{ other }.swap(*this); return *this; }
+        cow& operator=(cow&& other) noexcept { cow{ std::move(other) }.swap(*this); return *this; }
+        ~cow() { release(block_); }
+
+        // Const access
+        const T& get() const noexcept { return block_ ? block_->value : empty(); }
+        const T& operator*() const noexcept { return get(); }
+        const T* operator->() const noexcept { return &get(); }
+        operator const T&() const noexcept { return get(); }
+
+        // Write access, copying the value first if it is shared; call it again after copying this instance
+        T& mutate()
+        {
+            if (!block_)
+                block_ = new block();
+            else if (block_->references.load(std::memory_order_acquire) != 1)
+            {
+                block* copy = new block(block_->value);
+                release(std::exchange(block_, copy));
+            }
+            return block_->value;
+        }
+
+        bool unique() const noexcept { return !block_ || block_->references.load(std::memory_order_acquire) == 1; }
+        std::size_t use_count() const noexcept { return block_ ? block_->references.load(std::memory_order_relaxed) : 0; }
+        void swap(cow& other) noexcept { std::swap(block_, other.block_); }
+
+        // Comparison operators
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator==(const Arg& arg) const { return same(arg) || get() == value_of(arg); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator!=(const Arg& arg) const { return !same(arg) && get() != value_of(arg); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator< (const Arg& arg) const { return get() < value_of(arg); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator<=(const Arg& arg) const { return get() <= value_of(arg); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator> (const Arg& arg) const { return get() > value_of(arg); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator>=(const Arg& arg) const { return get() >= value_of(arg); }
+#ifdef STRONG_ALIAS_THREE_WAY_COMPARISON
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        auto operator<=>(const Arg& arg) const -> decltype(std::declval<const T&>() <=> value_of(arg)) { return get() <=> value_of(arg); }
+#endif
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator==(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator!=(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator< (const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator<=(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator> (const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator>=(const Arg& arg) const = delete;
+#ifdef STRONG_ALIAS_THREE_WAY_COMPARISON
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        void operator<=>(const Arg& arg) const = delete;
+#endif
+
+    private:
+        static const T& empty() { static const T value{}; return value; }
+        static block* acquire(block* b) noexcept
+        {
+            if (b)
+                b->references.fetch_add(1, std::memory_order_relaxed);
+            return b;
+        }
+        static void release(block* b) noexcept
+        {
+            if (b && b->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete b;
+        }
+
+        block* block_ = nullptr;
+    };
+}
+
+
+#ifdef STRONG_COW_TEST
+#include <vector>
+COW_ALIAS(Snapshot, std::vector<double>);
+COW_ALIAS(Backup, std::vector<double>);
+ALIAS(Rows, std::vector<double>);
+
+int main()
+{
+    { Snapshot a{ 1024 }; Snapshot b = a; b.use_count(); }                 // ✔️
+    { Snapshot a{ 1024 }; Snapshot b = a; (void)b->size(); b.unique(); }  // ✔️ reading does not copy
+    { Snapshot a{ 1024 }; Snapshot b = a; b.mutate().push_back(1.); }     // ✔️
+    { Snapshot a{ 1024 }; Snapshot b = a; b.mutate()[0] = 1.; }           // ✔️
+    { Snapshot a = std::vector<double>(16); }                             // ✔️
+    { Snapshot a; Backup b{ a }; }                                        // ✔️
+    { Snapshot a; Snapshot b; a == b; a <= b; a > b; a >= b; }            // ✔️
+    { Snapshot a; Snapshot b; a <=> b; }                                  // ✔️ C++20
+    { Snapshot a; const std::vector<double>& v = a; }                     // ✔️
+    { Snapshot a; Backup b = a; }                                         // ❌
+    { Snapshot a; Backup b; b = a; }                                      // ❌
+    { Snapshot a; Backup b; a == b; }                                     // ❌
+    { Snapshot a; Backup b; a >= b; }                                     // ❌
+    { Snapshot a{ 1024 }; Snapshot b = a; b->push_back(1.); }             // ❌ writes go through mutate()
+    { Snapshot a; [](Backup) {}(a); }                                     // ❌
+    { Rows r; Snapshot a = r; }                                           // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,129 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace strong
+{
+    // Union-find over a dense range of id aliases [0, size)
+    // unite() links by rank and is single-threaded, unite_concurrent() links by id with CAS and may be called from many threads.
+    // The two must not be mixed while other threads are running.
+    template<typename Id>
+    class disjoint_sets
+    {
+        static_assert(is_alias_v<Id> && std::is_unsigned_v<underlying_t<Id>>, "disjoint_sets ids must be aliases of unsigned integers");
+
+        using index_type = underlying_t<Id>;
+
+    public:
+        explicit disjoint_sets(std::size_t size)
+            : size_{ size }, parent_{ new std::atomic<index_type>[size] }, rank_{ new std::uint8_t[size]() }
+        {
+            for (std::size_t i = 0; i < size; ++i)
+                parent_[i].store(static_cast<index_type>(i), std::memory_order_relaxed);
+        }
+
+        // Representative of the set of id, halving the path on the way
+        Id find(Id id) noexcept
+        {
+            index_type x = id;
+            for (;;)
+            {
+                index_type parent = parent_[x].load(std::memory_order_relaxed);
+                if (parent == x)
+                    return Id{ x };
+                const index_type grandparent = parent_[parent].load(std::memory_order_relaxed);
+                // Only roots are ever relinked, so pointing x at any ancestor is safe under concurrency
+                if (grandparent != parent)
+                    parent_[x].store(grandparent, std::memory_order_relaxed);
+                x = grandparent;
+            }
+        }
+
+        // Returns false if a and b already were in the same set
+        bool unite(Id a, Id b) noexcept
+        {
+            index_type x = find(a), y = find(b);
+            if (x == y)
+                return false;
+            if (rank_[x] < rank_[y])
+                std::swap(x, y);
+            parent_[y].store(x, std::memory_order_relaxed);
+            rank_[x] += rank_[x] == rank_[y];
+            return true;
+        }
+
+        // Thread-safe union, the root with the larger id is linked under the other one
+        bool unite_concurrent(Id a, Id b) noexcept
+        {
+            for (;;)
+            {
+                index_type x = find(a), y = find(b);
+                if (x == y)
+                    return false;
+                if (x < y)
+                    std::swap(x, y);
+                index_type expected = x;
+                if (parent_[x].compare_exchange_weak(expected, y, std::memory_order_acq_rel, std::memory_order_relaxed))
+                    return true;
+            }
+        }
+
+        bool same(Id a, Id b) noexcept { return find(a) == find(b); }
+        std::size_t size() const noexcept { return size_; }
+
+    private:
+        std::size_t                                 size_;
+        std::unique_ptr<std::atomic<index_type>[]>  parent_;
+        std::unique_ptr<std::uint8_t[]>             rank_;
+    };
+}
+
+
+#ifdef STRONG_DISJOINT_SETS_TEST
+#include <cstdint>
+ALIAS(VertexId, std::uint32_t);
+ALIAS(EdgeId, std::uint32_t);
+ALIAS(Weight, double);
+
+int main()
+{
+    { strong::disjoint_sets<VertexId> s(8); s.unite(VertexId{ 1u }, VertexId{ 2u }); }       // ✔️
+    { strong::disjoint_sets<VertexId> s(8); s.unite_concurrent(1u, 2u); }                    // ✔️
+    { strong::disjoint_sets<VertexId> s(8); VertexId r = s.find(VertexId{ 1u }); }           // ✔️
+    { strong::disjoint_sets<VertexId> s(8); s.same(1u, 2u); }                                // ✔️
+    { strong::disjoint_sets<std::uint32_t> s(8); }                                           // ❌
+    { strong::disjoint_sets<Weight> s(8); }                                                  // ❌
+    { strong::disjoint_sets<VertexId> s(8); s.unite(EdgeId{ 1u }, VertexId{ 2u }); }         // ❌
+    { strong::disjoint_sets<VertexId> s(8); EdgeId r = s.find(VertexId{ 1u }); }             // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,347 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__AVX__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace strong
+{
+    namespace detail
+    {
+        // Scalar alias laid out exactly like its single member, so that arrays of either can be viewed as the other
+        template<typename Alias, typename = void>
+        struct is_mappable_alias : std::false_type {};
+        template<typename Alias>
+        struct is_mappable_alias<Alias, std::enable_if_t<is_alias_v<Alias>>>
+            : std::bool_constant<std::is_arithmetic_v<underlying_t<Alias>> && std::is_standard_layout_v<Alias> && std::is_trivially_copyable_v<Alias>
+                                 && sizeof(Alias) == sizeof(underlying_t<Alias>) && alignof(Alias) == alignof(underlying_t<Alias>)> {};
+        template<typename Alias>
+        inline constexpr bool is_mappable_alias_v = is_mappable_alias<Alias>::value;
+
+        template<typename Index, typename = void>
+        struct is_matrix_index : std::false_type {};
+        template<typename Index>
+        struct is_matrix_index<Index, std::enable_if_t<is_alias_v<Index>>> : std::is_integral<underlying_t<Index>> {};
+        template<typename Index>
+        inline constexpr bool is_matrix_index_v = is_matrix_index<Index>::value;
+
+        template<typename Index>
+        Eigen::Index matrix_index(const Index& index) noexcept { return static_cast<Eigen::Index>(underlying_t<Index>{ index }); }
+
+        template<typename Point>
+        inline constexpr bool is_point_alias_v = is_alias_v<Point> && std::is_same_v<underlying_t<Point>, Eigen::Vector3d>;
+
+        // Points are transformed in blocks copied to structure of arrays, so that each vector lane holds one point
+        inline constexpr std::size_t transform_block = 64;
+
+        // x' = r x + t on separate coordinate arrays, r row-major
+        inline void transform_soa(const double* r, const double* t, double* x, double* y, double* z, std::size_t count) noexcept
+        {
+            std::size_t i = 0;
+#if defined(__AVX512F__)
+            const __m512d r00 = _mm512_set1_pd(r[0]), r01 = _mm512_set1_pd(r[1]), r02 = _mm512_set1_pd(r[2]);
+            const __m512d r10 = _mm512_set1_pd(r[3]), r11 = _mm512_set1_pd(r[4]), r12 = _mm512_set1_pd(r[5]);
+            const __m512d r20 = _mm512_set1_pd(r[6]), r21 = _mm512_set1_pd(r[7]), r22 = _mm512_set1_pd(r[8]);
+            const __m512d t0 = _mm512_set1_pd(t[0]), t1 = _mm512_set1_pd(t[1]), t2 = _mm512_set1_pd(t[2]);
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m512d px = _mm512_loadu_pd(x + i), py = _mm512_loadu_pd(y + i), pz = _mm512_loadu_pd(z + i);
+                _mm512_storeu_pd(x + i, _mm512_fmadd_pd(r02, pz, _mm512_fmadd_pd(r01, py, _mm512_fmadd_pd(r00, px, t0))));
+                _mm512_storeu_pd(y + i, _mm512_fmadd_pd(r12, pz, _mm512_fmadd_pd(r11, py, _mm512_fmadd_pd(r10, px, t1))));
+                _mm512_storeu_pd(z + i, _mm512_fmadd_pd(r22, pz, _mm512_fmadd_pd(r21, py, _mm512_fmadd_pd(r20, px, t2))));
+            }
+#elif defined(__AVX__)
+            const __m256d r00 = _mm256_set1_pd(r[0]), r01 = _mm256_set1_pd(r[1]), r02 = _mm256_set1_pd(r[2]);
+            const __m256d r10 = _mm256_set1_pd(r[3]), r11 = _mm256_set1_pd(r[4]), r12 = _mm256_set1_pd(r[5]);
+            const __m256d r20 = _mm256_set1_pd(r[6]), r21 = _mm256_set1_pd(r[7]), r22 = _mm256_set1_pd(r[8]);
+            const __m256d t0 = _mm256_set1_pd(t[0]), t1 = _mm256_set1_pd(t[1]), t2 = _mm256_set1_pd(t[2]);
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m256d px = _mm256_loadu_pd(x + i), py = _mm256_loadu_pd(y + i), pz = _mm256_loadu_pd(z + i);
+#if defined(__FMA__)
+                _mm256_storeu_pd(x + i, _mm256_fmadd_pd(r02, pz, _mm256_fmadd_pd(r01, py, _mm256_fmadd_pd(r00, px, t0))));
+                _mm256_storeu_pd(y + i, _mm256_fmadd_pd(r12, pz, _mm256_fmadd_pd(r11, py, _mm256_fmadd_pd(r10, px, t1))));
+                _mm256_storeu_pd(z + i, _mm256_fmadd_pd(r22, pz, _mm256_fmadd_pd(r21, py, _mm256_fmadd_pd(r20, px, t2))));
+#else
+                _mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r00, px), _mm256_mul_pd(r01, py)), _mm256_add_pd(_mm256_mul_pd(r02, pz), t0)));
+                _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r10, px), _mm256_mul_pd(r11, py)), _mm256_add_pd(_mm256_mul_pd(r12, pz), t1)));
+                _mm256_storeu_pd(z + i, _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(r20, px), _mm256_mul_pd(r21, py)), _mm256_add_pd(_mm256_mul_pd(r22, pz), t2)));
+#endif
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                const double px = x[i], py = y[i], pz = z[i];
+                x[i] = r[0] * px + r[1] * py + r[2] * pz + t[0];
+                y[i] = r[3] * px + r[4] * py + r[5] * pz + t[1];
+                z[i] = r[6] * px + r[7] * py + r[8] * pz + t[2];
+            }
+        }
+    }
+
+    // Eigen column vector viewing a contiguous buffer of scalar aliases without copying, read-only for span<const Alias>
+    template<typename Alias>
+    auto eigen_map(std::span<Alias> values) noexcept
+    {
+        using T = underlying_t<std::remove_const_t<Alias>>;
+        using vector = std::conditional_t<std::is_const_v<Alias>, const Eigen::Matrix<T, Eigen::Dynamic, 1>, Eigen::Matrix<T, Eigen::Dynamic, 1>>;
+        using pointer = std::conditional_t<std::is_const_v<Alias>, const T*, T*>;
+        static_assert(detail::is_mappable_alias_v<std::remove_const_t<Alias>>, "eigen_map requires aliases of arithmetic types laid out as their underlying type");
+        return Eigen::Map<vector>{ reinterpret_cast<pointer>(values.data()), static_cast<Eigen::Index>(values.size()) };
+    }
+
+    // Typed view of the coefficients of a dense Eigen vector or matrix, in storage order
+    template<typename Alias, typename Derived>
+    std::span<Alias> alias_span(Eigen::PlainObjectBase<Derived>& values) noexcept
+    {
+        static_assert(detail::is_mappable_alias_v<Alias>, "alias_span requires aliases of arithmetic types laid out as their underlying type");
+        static_assert(std::is_same_v<typename Derived::Scalar, underlying_t<Alias>>, "alias_span requires the Eigen scalar to be the alias' underlying type");
+        return { reinterpret_cast<Alias*>(values.data()), static_cast<std::size_t>(values.size()) };
+    }
+    template<typename Alias, typename Derived>
+    std::span<const Alias> alias_span(const Eigen::PlainObjectBase<Derived>& values) noexcept
+    {
+        static_assert(detail::is_mappable_alias_v<Alias>, "alias_span requires aliases of arithmetic types laid out as their underlying type");
+        static_assert(std::is_same_v<typename Derived::Scalar, underlying_t<Alias>>, "alias_span requires the Eigen scalar to be the alias' underlying type");
+        return { reinterpret_cast<const Alias*>(values.data()), static_cast<std::size_t>(values.size()) };
+    }
+
+    // Rigid transform between two frames, each tagged by a class alias of Eigen::Vector3d
+    template<typename From, typename To>
+    class transform
+    {
+        static_assert(detail::is_point_alias_v<From> && detail::is_point_alias_v<To>, "transform frames must be aliases of Eigen::Vector3d");
+
+    public:
+        transform() : rotation_{ Eigen::Matrix3d::Identity() }, translation_{ Eigen::Vector3d::Zero() } {}
+        transform(const Eigen::Matrix3d& rotation, const Eigen::Vector3d& translation) : rotation_{ rotation }, translation_{ translation } {}
+        explicit transform(const Eigen::Isometry3d& isometry) : rotation_{ isometry.linear() }, translation_{ isometry.translation() } {}
+
+        const Eigen::Matrix3d& rotation() const noexcept { return rotation_; }
+        const Eigen::Vector3d& translation() const noexcept { return translation_; }
+
+        To operator()(const From& point) const { return To{ Eigen::Vector3d{ rotation_ * point + translation_ } }; }
+        // Batched, out must be at least as long as in
+        void operator()(std::span<const From> in, std::span<To> out) const
+        {
+            assert(out.size() >= in.size() && "transform output is shorter than its input");
+            alignas(64) double x[detail::transform_block], y[detail::transform_block], z[detail::transform_block];
+            alignas(64) double r[9];
+            for (int row = 0; row < 3; ++row)
+                for (int col = 0; col < 3; ++col) r[3 * row + col] = rotation_(row, col);
+            for (std::size_t begin = 0; begin < in.size(); begin += detail::transform_block)
+            {
+                const std::size_t count = std::min(detail::transform_block, in.size() - begin);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const Eigen::Vector3d& p = in[begin + i];
+                    x[i] = p.x(); y[i] = p.y(); z[i] = p.z();
+                }
+                detail::transform_soa(r, translation_.data(), x, y, z, count);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    Eigen::Vector3d& p = out[begin + i];
+                    p.x() = x[i]; p.y() = y[i]; p.z() = z[i];
+                }
+            }
+        }
+
+        transform<To, From> inverse() const
+        {
+            const Eigen::Matrix3d transposed = rotation_.transpose();
+            return transform<To, From>{ transposed, -(transposed * translation_) };
+        }
+        // Composition, applying other first
+        template<typename Source>
+        transform<Source, To> operator*(const transform<Source, From>& other) const
+        {
+            return transform<Source, To>{ rotation_ * other.rotation(), rotation_ * other.translation() + translation_ };
+        }
+
+    private:
+        Eigen::Matrix3d rotation_;
+        Eigen::Vector3d translation_;
+    };
+
+    // Dense or sparse Eigen matrix whose elements are only accessed through the declared row and column aliases
+    // The untyped operator() is hidden, the underlying matrix stays available to Eigen algorithms.
+    template<typename Row, typename Col, typename Matrix>
+    class indexed_matrix : public Matrix
+    {
+        static_assert(detail::is_matrix_index_v<Row> && detail::is_matrix_index_v<Col>, "indexed_matrix indices must be aliases of integers");
+
+    public:
+        using Matrix::Matrix;
+        using Matrix::operator=;
+        indexed_matrix() = default;
+        indexed_matrix(const Matrix& matrix) : Matrix(matrix) {}
+        indexed_matrix(Matrix&& matrix) noexcept : Matrix(std::move(matrix)) {}
+
+        indexed_matrix(const Row& rows, const Col& cols) : Matrix(detail::matrix_index(rows), detail::matrix_index(cols)) {}
+
+        decltype(auto) operator()(const Row& row, const Col& col) { return this->coeffRef(detail::matrix_index(row), detail::matrix_index(col)); }
+        decltype(auto) operator()(const Row& row, const Col& col) const { return this->coeff(detail::matrix_index(row), detail::matrix_index(col)); }
+
+        Matrix& matrix() noexcept { return *this; }
+        const Matrix& matrix() const noexcept { return *this; }
+    };
+
+    // Sparse matrix builder taking typed (row, column, value) entries, duplicates are summed
+    template<typename Row, typename Col, typename Scalar = double>
+    class triplets
+    {
+        static_assert(detail::is_matrix_index_v<Row> && detail::is_matrix_index_v<Col>, "triplets indices must be aliases of integers");
+
+    public:
+        using matrix_type = indexed_matrix<Row, Col, Eigen::SparseMatrix<Scalar>>;
+
+        void reserve(std::size_t count) { entries_.reserve(count); }
+        std::size_t size() const noexcept { return entries_.size(); }
+        void clear() noexcept { entries_.clear(); }
+
+        void add(const Row& row, const Col& col, const Scalar& value)
+        {
+            entries_.emplace_back(static_cast<storage_index>(detail::matrix_index(row)), static_cast<storage_index>(detail::matrix_index(col)), value);
+        }
+        void merge(const triplets& other) { entries_.insert(entries_.end(), other.entries_.begin(), other.entries_.end()); }
+
+        matrix_type build(const Row& rows, const Col& cols) const
+        {
+            matrix_type matrix{ rows, cols };
+            matrix.setFromTriplets(entries_.begin(), entries_.end());
+            return matrix;
+        }
+
+    private:
+        using storage_index = typename Eigen::SparseMatrix<Scalar>::StorageIndex;
+        using entry = Eigen::Triplet<Scalar, storage_index>;
+        std::vector<entry> entries_;
+    };
+
+    // Calls element(e, local) for every e in [0, elements), each thread adding to its own triplets,
+    // then merges them in thread order and builds the summed sparse matrix
+    template<typename Row, typename Col, typename Scalar = double, typename F>
+    typename triplets<Row, Col, Scalar>::matrix_type assemble(const Row& rows, const Col& cols, std::size_t elements, F&& element, std::size_t threads = 1)
+    {
+        threads = std::max<std::size_t>(1, std::min(threads, elements));
+        std::vector<triplets<Row, Col, Scalar>> locals(threads);
+        const std::size_t chunk = (elements + threads - 1) / threads;
+        auto work = [&](std::size_t thread)
+        {
+            const std::size_t last = std::min(elements, (thread + 1) * chunk);
+            for (std::size_t e = thread * chunk; e < last; ++e)
+                element(e, locals[thread]);
+        };
+        std::vector<std::thread> workers;
+        for (std::size_t thread = 1; thread < threads; ++thread)
+            workers.emplace_back(work, thread);
+        work(0);
+        for (std::thread& worker : workers)
+            worker.join();
+
+        std::size_t total = 0;
+        for (const auto& local : locals) total += local.size();
+        triplets<Row, Col, Scalar> all = std::move(locals[0]);
+        all.reserve(total);
+        for (std::size_t thread = 1; thread < threads; ++thread)
+        {
+            all.merge(locals[thread]);
+            locals[thread] = {};
+        }
+        return all.build(rows, cols);
+    }
+}
+
+
+#ifdef STRONG_EIGEN_TEST
+#include <vector>
+ALIAS(WorldPoint, Eigen::Vector3d);
+ALIAS(BodyPoint, Eigen::Vector3d);
+ALIAS(CameraPoint, Eigen::Vector3d);
+ALIAS(Meters, double);
+ALIAS(Seconds, double);
+ALIAS(Count, int);
+ALIAS(GlobalDof, int);
+ALIAS(LocalDof, int);
+ALIAS(Stiffness, strong::indexed_matrix<GlobalDof, GlobalDof, Eigen::MatrixXd>);
+
+int main()
+{
+    strong::transform<BodyPoint, WorldPoint> body_to_world{ Eigen::Matrix3d::Identity(), Eigen::Vector3d{ 1., 2., 3. } };
+    strong::transform<CameraPoint, BodyPoint> camera_to_body;
+    std::vector<BodyPoint> body(10);
+    std::vector<WorldPoint> world(10);
+    { WorldPoint w = body_to_world(BodyPoint{ 0., 0., 1. }); }                      // ✔️
+    { body_to_world(body, world); }                                                 // ✔️
+    { strong::transform<WorldPoint, BodyPoint> back = body_to_world.inverse(); }    // ✔️
+    { strong::transform<CameraPoint, WorldPoint> t = body_to_world * camera_to_body; } // ✔️
+    std::vector<Meters> meters(10);
+    const std::vector<Meters> fixed(10);
+    Eigen::VectorXd v = Eigen::VectorXd::Zero(10);
+    { double norm = strong::eigen_map<Meters>(meters).norm(); }                     // ✔️
+    { strong::eigen_map<Meters>(meters) *= 2.; }                                    // ✔️
+    { double sum = strong::eigen_map<const Meters>(fixed).sum(); }                  // ✔️
+    { double max = strong::eigen_map(std::span{ meters }).maxCoeff(); }             // ✔️
+    { std::span<Meters> s = strong::alias_span<Meters>(v); s[0] = Meters{ 1. }; }  // ✔️
+    Stiffness k{ Eigen::MatrixXd::Zero(4, 4) };
+    strong::indexed_matrix<LocalDof, GlobalDof, Eigen::MatrixXd> gather_matrix{ LocalDof{ 2 }, GlobalDof{ 4 } };
+    strong::triplets<GlobalDof, GlobalDof> entries;
+    { k(GlobalDof{ 1 }, GlobalDof{ 2 }) += 1.; double d = k.matrix().determinant(); } // ✔️
+    { gather_matrix(LocalDof{ 0 }, GlobalDof{ 3 }) = 1.; }                          // ✔️
+    { entries.add(GlobalDof{ 0 }, GlobalDof{ 1 }, 2.); auto s = entries.build(GlobalDof{ 4 }, GlobalDof{ 4 }); double x = s(GlobalDof{ 0 }, GlobalDof{ 1 }); } // ✔️
+    { auto s = strong::assemble(GlobalDof{ 4 }, GlobalDof{ 4 }, 3, [](std::size_t e, auto& local) { local.add(GlobalDof{ int(e) }, GlobalDof{ int(e) }, 1.); }, 2); } // ✔️
+    { body_to_world(WorldPoint{ 0., 0., 1. }); }                                    // ❌
+    { BodyPoint b = body_to_world(BodyPoint{ 0., 0., 1. }); }                       // ❌
+    { body_to_world(world, body); }                                                 // ❌
+    { camera_to_body * body_to_world; }                                             // ❌
+    { strong::transform<Eigen::Vector3d, WorldPoint> t; }                           // ❌
+    { strong::eigen_map<Seconds>(meters); }                                         // ❌
+    { strong::eigen_map<const Meters>(fixed) *= 2.; }                               // ❌
+    { strong::eigen_map<Meters>(fixed); }                                           // ❌
+    { strong::eigen_map<double>(std::vector<double>{}); }                           // ❌
+    { strong::eigen_map<BodyPoint>(body); }                                         // ❌
+    { strong::alias_span<Count>(v); }                                               // ❌
+    { std::span<Seconds> s = strong::alias_span<Meters>(v); }                       // ❌
+    { k(LocalDof{ 1 }, GlobalDof{ 2 }) = 1.; }                                      // ❌
+    { gather_matrix(GlobalDof{ 3 }, LocalDof{ 0 }) = 1.; }                          // ❌
+    { entries.add(LocalDof{ 0 }, GlobalDof{ 1 }, 2.); }                             // ❌
+    { strong::triplets<GlobalDof, GlobalDof> t; t.build(LocalDof{ 4 }, GlobalDof{ 4 }); } // ❌
+    { strong::indexed_matrix<int, GlobalDof, Eigen::MatrixXd> m; }                  // ❌
+
+    return 0;
+}
+#endif
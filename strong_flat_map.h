@@ -0,0 +1,309 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace strong
+{
+    // Tag for constructors taking keys already sorted and without duplicates
+    struct sorted_unique_t { explicit sorted_unique_t() = default; };
+    inline constexpr sorted_unique_t sorted_unique{};
+
+    namespace detail
+    {
+        template<typename Key>
+        inline constexpr bool is_flat_key_v = is_alias_v<Key> && std::is_arithmetic_v<underlying_t<Key>>
+            && std::is_standard_layout_v<Key> && sizeof(Key) == sizeof(underlying_t<Key>);
+
+#if defined(__AVX2__)
+        inline unsigned popcount(unsigned bits) noexcept
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return __popcnt(bits);
+#else
+            return static_cast<unsigned>(__builtin_popcount(bits));
+#endif
+        }
+#endif
+
+        // Number of keys less than x among the n first ones
+        template<typename T>
+        std::size_t count_less(const T* keys, std::size_t n, T x) noexcept
+        {
+            std::size_t count = 0, i = 0;
+#if defined(__AVX2__)
+            if constexpr (std::is_integral_v<T>)
+            {
+                // Signed comparison on keys biased by the sign bit handles unsigned keys too
+                using signed_t = std::make_signed_t<T>;
+                constexpr T bias = std::is_signed_v<T> ? T{ 0 } : static_cast<T>(T{ 1 } << (8 * sizeof(T) - 1));
+                const signed_t biased = static_cast<signed_t>(x ^ bias);
+                __m256i needle, flip;
+                if constexpr (sizeof(T) == 1) { needle = _mm256_set1_epi8(biased);  flip = _mm256_set1_epi8(static_cast<signed_t>(bias)); }
+                if constexpr (sizeof(T) == 2) { needle = _mm256_set1_epi16(biased); flip = _mm256_set1_epi16(static_cast<signed_t>(bias)); }
+                if constexpr (sizeof(T) == 4) { needle = _mm256_set1_epi32(biased); flip = _mm256_set1_epi32(static_cast<signed_t>(bias)); }
+                if constexpr (sizeof(T) == 8) { needle = _mm256_set1_epi64x(biased); flip = _mm256_set1_epi64x(static_cast<signed_t>(bias)); }
+                constexpr std::size_t lanes = 32 / sizeof(T);
+                for (; i + lanes <= n; i += lanes)
+                {
+                    const __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flip);
+                    __m256i less;
+                    if constexpr (sizeof(T) == 1) less = _mm256_cmpgt_epi8(needle, block);
+                    if constexpr (sizeof(T) == 2) less = _mm256_cmpgt_epi16(needle, block);
+                    if constexpr (sizeof(T) == 4) less = _mm256_cmpgt_epi32(needle, block);
+                    if constexpr (sizeof(T) == 8) less = _mm256_cmpgt_epi64(needle, block);
+                    count += popcount(static_cast<unsigned>(_mm256_movemask_epi8(less))) / sizeof(T);
+                }
+            }
+#endif
+            for (; i < n; ++i)
+                count += keys[i] < x;
+            return count;
+        }
+
+        // Branchless binary search narrowing down to a window scanned with SIMD
+        template<typename Key>
+        std::size_t lower_bound(const Key* keys, std::size_t n, underlying_t<Key> x) noexcept
+        {
+            constexpr std::size_t window = 4 * cache_line_size / sizeof(Key);
+            const underlying_t<Key>* base = reinterpret_cast<const underlying_t<Key>*>(keys);
+            const underlying_t<Key>* const first = base;
+            while (n > window)
+            {
+                const std::size_t half = n / 2;
+                base = base[half] < x ? base + half : base;
+                n -= half;
+            }
+            return static_cast<std::size_t>(base - first) + count_less(base, n, x);
+        }
+
+        // Indices sorting keys, keeping the first of equal keys and dropping the others
+        template<typename Key>
+        std::vector<std::size_t> sorted_unique_order(const std::vector<Key>& keys)
+        {
+            std::vector<std::size_t> order(keys.size());
+            std::iota(order.begin(), order.end(), std::size_t{ 0 });
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return keys[a] < keys[b]; });
+            order.erase(std::unique(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return keys[a] == keys[b]; }), order.end());
+            return order;
+        }
+    }
+
+    // Sorted associative container keyed by scalar aliases, with keys and values in separate arrays
+    template<typename Key, typename Value>
+    class flat_map
+    {
+        static_assert(detail::is_flat_key_v<Key>, "flat_map keys must be aliases of arithmetic types");
+
+    public:
+        using key_type    = Key;
+        using mapped_type = Value;
+
+        flat_map() = default;
+        // Bulk construction, sorting keys and keeping the first value of duplicates
+        flat_map(std::vector<Key> keys, std::vector<Value> values)
+        {
+            assert(keys.size() == values.size() && "flat_map needs one value per key");
+            const std::vector<std::size_t> order = detail::sorted_unique_order(keys);
+            keys_.reserve(order.size());
+            values_.reserve(order.size());
+            for (std::size_t i : order)
+            {
+                keys_.push_back(keys[i]);
+                values_.push_back(std::move(values[i]));
+            }
+        }
+        flat_map(sorted_unique_t, std::vector<Key> keys, std::vector<Value> values) noexcept
+            : keys_(std::move(keys)), values_(std::move(values))
+        {
+            assert(keys_.size() == values_.size() && "flat_map needs one value per key");
+        }
+
+        // Lookup by the same alias, or by its underlying type
+        std::size_t lower_bound(const Key& key) const noexcept { return detail::lower_bound(keys_.data(), keys_.size(), key); }
+        bool contains(const Key& key) const noexcept { return find(key) != nullptr; }
+        Value* find(const Key& key) noexcept { return const_cast<Value*>(std::as_const(*this).find(key)); }
+        const Value* find(const Key& key) const noexcept
+        {
+            const std::size_t i = lower_bound(key);
+            return i != keys_.size() && keys_[i] == key ? &values_[i] : nullptr;
+        }
+        Value& operator[](const Key& key) { return try_emplace(key).first; }
+
+        // Returns the value of key and whether it was inserted
+        template<typename... Args>
+        std::pair<Value&, bool> try_emplace(const Key& key, Args&&... args)
+        {
+            const std::size_t i = lower_bound(key);
+            if (i != keys_.size() && keys_[i] == key)
+                return { values_[i], false };
+            keys_.insert(keys_.begin() + i, key);
+            values_.insert(values_.begin() + i, Value(std::forward<Args>(args)...));
+            return { values_[i], true };
+        }
+        bool insert(const Key& key, Value value) { return try_emplace(key, std::move(value)).second; }
+
+        // Bulk insertion in a single linear merge, keys already present keep their value
+        void merge(flat_map other)
+        {
+            std::vector<Key> keys;
+            std::vector<Value> values;
+            keys.reserve(keys_.size() + other.keys_.size());
+            values.reserve(keys_.size() + other.keys_.size());
+            std::size_t i = 0, j = 0;
+            while (i < keys_.size() || j < other.keys_.size())
+            {
+                const bool mine = j == other.keys_.size() || (i < keys_.size() && !(other.keys_[j] < keys_[i]));
+                if (mine && j < other.keys_.size() && keys_[i] == other.keys_[j])
+                    ++j;
+                keys.push_back(mine ? keys_[i] : other.keys_[j]);
+                values.push_back(std::move(mine ? values_[i++] : other.values_[j++]));
+            }
+            keys_ = std::move(keys);
+            values_ = std::move(values);
+        }
+        void merge(std::vector<Key> keys, std::vector<Value> values) { merge(flat_map{ std::move(keys), std::move(values) }); }
+
+        bool erase(const Key& key)
+        {
+            const std::size_t i = lower_bound(key);
+            if (i == keys_.size() || keys_[i] != key)
+                return false;
+            keys_.erase(keys_.begin() + i);
+            values_.erase(values_.begin() + i);
+            return true;
+        }
+
+        std::size_t size()  const noexcept { return keys_.size(); }
+        bool        empty() const noexcept { return keys_.empty(); }
+        void        reserve(std::size_t n) { keys_.reserve(n); values_.reserve(n); }
+        // Sorted keys, values()[i] is mapped to keys()[i]
+        const std::vector<Key>&   keys()   const noexcept { return keys_; }
+        std::vector<Value>&       values()       noexcept { return values_; }
+        const std::vector<Value>& values() const noexcept { return values_; }
+
+    private:
+        std::vector<Key>   keys_;
+        std::vector<Value> values_;
+    };
+
+    // Sorted set of scalar aliases
+    template<typename Key>
+    class flat_set
+    {
+        static_assert(detail::is_flat_key_v<Key>, "flat_set keys must be aliases of arithmetic types");
+
+    public:
+        using key_type = Key;
+
+        flat_set() = default;
+        explicit flat_set(std::vector<Key> keys)
+            : keys_(std::move(keys))
+        {
+            std::sort(keys_.begin(), keys_.end());
+            keys_.erase(std::unique(keys_.begin(), keys_.end()), keys_.end());
+        }
+        flat_set(sorted_unique_t, std::vector<Key> keys) noexcept : keys_(std::move(keys)) {}
+
+        std::size_t lower_bound(const Key& key) const noexcept { return detail::lower_bound(keys_.data(), keys_.size(), key); }
+        bool contains(const Key& key) const noexcept
+        {
+            const std::size_t i = lower_bound(key);
+            return i != keys_.size() && keys_[i] == key;
+        }
+        bool insert(const Key& key)
+        {
+            const std::size_t i = lower_bound(key);
+            if (i != keys_.size() && keys_[i] == key)
+                return false;
+            keys_.insert(keys_.begin() + i, key);
+            return true;
+        }
+        // Bulk insertion in a single linear merge
+        void merge(const flat_set& other)
+        {
+            std::vector<Key> keys;
+            keys.reserve(keys_.size() + other.keys_.size());
+            std::set_union(keys_.begin(), keys_.end(), other.keys_.begin(), other.keys_.end(), std::back_inserter(keys));
+            keys_ = std::move(keys);
+        }
+        void merge(std::vector<Key> keys) { merge(flat_set{ std::move(keys) }); }
+        bool erase(const Key& key)
+        {
+            const std::size_t i = lower_bound(key);
+            if (i == keys_.size() || keys_[i] != key)
+                return false;
+            keys_.erase(keys_.begin() + i);
+            return true;
+        }
+
+        std::size_t size()  const noexcept { return keys_.size(); }
+        bool        empty() const noexcept { return keys_.empty(); }
+        auto begin() const noexcept { return keys_.begin(); }
+        auto end()   const noexcept { return keys_.end(); }
+        const std::vector<Key>& keys() const noexcept { return keys_; }
+
+    private:
+        std::vector<Key> keys_;
+    };
+}
+
+
+#ifdef STRONG_FLAT_MAP_TEST
+#include <cstdint>
+#include <string>
+ALIAS(SymbolId, std::uint16_t);
+ALIAS(VenueId, std::uint16_t);
+ALIAS(Name, std::string);
+
+int main()
+{
+    strong::flat_map<SymbolId, double> m{ { SymbolId{ std::uint16_t{ 3 } }, SymbolId{ std::uint16_t{ 1 } } }, { 3., 1. } };
+    { m.find(SymbolId{ std::uint16_t{ 3 } }); }                                 // ✔️
+    { m.find(std::uint16_t{ 3 }); }                                             // ✔️
+    { m[SymbolId{ std::uint16_t{ 2 } }] = 2.; m.insert(SymbolId{ std::uint16_t{ 5 } }, 5.); m.erase(SymbolId{ std::uint16_t{ 1 } }); } // ✔️
+    { m.merge({ SymbolId{ std::uint16_t{ 4 } }, SymbolId{ std::uint16_t{ 0 } } }, { 4., 0. }); } // ✔️
+    { strong::flat_map<SymbolId, Name> n{ strong::sorted_unique, { SymbolId{ std::uint16_t{ 1 } } }, { Name{ "a" } } }; } // ✔️
+    { strong::flat_set<SymbolId> s{ { SymbolId{ std::uint16_t{ 2 } }, SymbolId{ std::uint16_t{ 1 } } } }; s.contains(std::uint16_t{ 1 }); } // ✔️
+    { strong::flat_map<std::uint16_t, double> n; }                              // ❌
+    { strong::flat_map<Name, double> n; }                                       // ❌
+    { m.find(VenueId{ std::uint16_t{ 3 } }); }                                  // ❌
+    { m[VenueId{ std::uint16_t{ 3 } }] = 1.; }                                  // ❌
+    { strong::flat_set<SymbolId> s; s.insert(VenueId{ std::uint16_t{ 1 } }); }  // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,286 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace strong
+{
+    // Distance, in elements, at which random accesses are prefetched ahead of their use
+    inline constexpr std::size_t prefetch_distance = 16;
+
+    namespace detail
+    {
+        template<typename Index, typename = void>
+        struct is_index_alias : std::false_type {};
+        template<typename Index>
+        struct is_index_alias<Index, std::enable_if_t<is_alias_v<Index>>>
+            : std::bool_constant<std::is_integral_v<underlying_t<Index>> && std::is_standard_layout_v<Index> && sizeof(Index) == sizeof(underlying_t<Index>)> {};
+        template<typename Index>
+        inline constexpr bool is_index_alias_v = is_index_alias<Index>::value;
+
+        template<bool Write = false, typename T>
+        inline void prefetch(const T* p) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p, Write);
+#elif defined(__AVX2__) || defined(__AVX512F__)
+            _mm_prefetch(reinterpret_cast<const char*>(p), _MM_HINT_T0);
+#endif
+        }
+
+        // Index alias arrays are read as arrays of their single member
+        template<typename Index>
+        inline const underlying_t<Index>* raw(const Index* indices) noexcept { return reinterpret_cast<const underlying_t<Index>*>(indices); }
+
+        // Preconditions checked by assertions
+        template<typename T>
+        bool all_below(const T* indices, std::size_t n, std::size_t bound) noexcept
+        {
+            return std::all_of(indices, indices + n, [bound](T i) { return static_cast<std::size_t>(i) < bound; });
+        }
+        template<typename T>
+        bool is_permutation(const T* indices, std::size_t n)
+        {
+            std::vector<bool> seen(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const std::size_t index = static_cast<std::size_t>(indices[i]);
+                if (index >= n || seen[index])
+                    return false;
+                seen[index] = true;
+            }
+            return true;
+        }
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+        // Load lanes indices widened to 64 bits
+        template<std::size_t Lanes, typename I>
+        inline auto load_indices(const I* p) noexcept
+        {
+#if defined(__AVX512F__)
+            if constexpr (Lanes == 8)
+            {
+                if constexpr (sizeof(I) == 8) return _mm512_loadu_si512(p);
+                else if constexpr (std::is_signed_v<I>) return _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+                else return _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+            }
+            else
+#endif
+            {
+                if constexpr (sizeof(I) == 8) return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+                else if constexpr (std::is_signed_v<I>) return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+                else return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            }
+        }
+
+        // Hardware gather of lanes elements of 4 or 8 bytes
+        template<std::size_t Lanes, typename T, typename I>
+        inline void gather_lanes(const T* src, const I* indices, T* dst) noexcept
+        {
+            const auto index = load_indices<Lanes>(indices);
+#if defined(__AVX512F__)
+            if constexpr (Lanes == 8)
+            {
+                if constexpr (sizeof(T) == 8) _mm512_storeu_si512(dst, _mm512_i64gather_epi64(index, src, 8));
+                else _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm512_i64gather_epi32(index, src, 4));
+            }
+            else
+#endif
+            {
+                if constexpr (sizeof(T) == 8) _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src), index, 8));
+                else _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_i64gather_epi32(reinterpret_cast<const int*>(src), index, 4));
+            }
+        }
+#endif
+
+        template<typename T, typename I>
+        void gather_range(const T* src, const I* indices, T* dst, std::size_t first, std::size_t last) noexcept(std::is_nothrow_copy_assignable_v<T>)
+        {
+            std::size_t i = first;
+#if defined(__AVX512F__) || defined(__AVX2__)
+            if constexpr (std::is_trivially_copyable_v<T> && (sizeof(T) == 4 || sizeof(T) == 8) && (sizeof(I) == 4 || sizeof(I) == 8))
+            {
+#if defined(__AVX512F__)
+                constexpr std::size_t lanes = 8;
+#else
+                constexpr std::size_t lanes = 4;
+#endif
+                for (; i + lanes + prefetch_distance <= last; i += lanes)
+                {
+                    for (std::size_t k = 0; k < lanes; ++k)
+                        prefetch(src + indices[i + prefetch_distance + k]);
+                    gather_lanes<lanes>(src, indices + i, dst + i);
+                }
+            }
+#endif
+            for (; i < last; ++i)
+            {
+                if (i + prefetch_distance < last)
+                    prefetch(src + indices[i + prefetch_distance]);
+                dst[i] = src[indices[i]];
+            }
+        }
+
+        template<typename T, typename I>
+        void scatter_range(const T* src, const I* indices, T* dst, std::size_t first, std::size_t last) noexcept(std::is_nothrow_copy_assignable_v<T>)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                if (i + prefetch_distance < last)
+                    prefetch<true>(dst + indices[i + prefetch_distance]);
+                dst[indices[i]] = src[i];
+            }
+        }
+
+        // Split [0, n) in cache line friendly chunks, the calling thread processing the last one
+        template<typename F>
+        void parallel_for(std::size_t n, std::size_t threads, F&& f)
+        {
+            constexpr std::size_t grain = 4096;
+            threads = std::max<std::size_t>(1, std::min(threads, n / grain));
+            const std::size_t chunk = (n / threads + 63) & ~std::size_t{ 63 };
+            std::vector<std::thread> workers;
+            std::size_t first = 0;
+            for (; workers.size() + 1 < threads && first + chunk < n; first += chunk)
+                workers.emplace_back([&f, first, last = first + chunk] { f(first, last); });
+            f(first, n);
+            for (std::thread& worker : workers)
+                worker.join();
+        }
+
+        template<typename Range>
+        using range_value_t = std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<Range&>()))>>;
+    }
+
+    // destination[i] = source[indices[i]], for i in [0, indices.size())
+    template<typename Index, typename Source, typename Destination>
+    void gather(const Source& source, std::span<const Index> indices, Destination&& destination, std::size_t threads = 1)
+    {
+        static_assert(detail::is_index_alias_v<Index>, "gather indices must be aliases of integers");
+        static_assert(std::is_same_v<detail::range_value_t<const Source>, detail::range_value_t<Destination>>, "gather source and destination must hold the same type");
+        const auto* src = std::data(source);
+        auto* dst = std::data(destination);
+        const auto* raw = detail::raw(indices.data());
+        assert(std::size(destination) >= indices.size() && "gather destination is too small");
+        assert(detail::all_below(raw, indices.size(), std::size(source)) && "gather index out of the source");
+        detail::parallel_for(indices.size(), threads, [&](std::size_t first, std::size_t last) { detail::gather_range(src, raw, dst, first, last); });
+    }
+
+    // destination[indices[i]] = source[i], indices must be unique when using several threads
+    template<typename Index, typename Source, typename Destination>
+    void scatter(const Source& source, std::span<const Index> indices, Destination&& destination, std::size_t threads = 1)
+    {
+        static_assert(detail::is_index_alias_v<Index>, "scatter indices must be aliases of integers");
+        static_assert(std::is_same_v<detail::range_value_t<const Source>, detail::range_value_t<Destination>>, "scatter source and destination must hold the same type");
+        const auto* src = std::data(source);
+        auto* dst = std::data(destination);
+        const auto* raw = detail::raw(indices.data());
+        assert(std::size(source) >= indices.size() && "scatter source is too small");
+        assert(detail::all_below(raw, indices.size(), std::size(destination)) && "scatter index out of the destination");
+        detail::parallel_for(indices.size(), threads, [&](std::size_t first, std::size_t last) { detail::scatter_range(src, raw, dst, first, last); });
+    }
+
+    // In-place data[i] = data[permutation[i]], following cycles
+    // permutation must hold every position in [0, permutation.size()) exactly once, otherwise a cycle never closes.
+    template<typename Index, typename Data>
+    void apply_permutation(std::span<const Index> permutation, Data&& data)
+    {
+        static_assert(detail::is_index_alias_v<Index>, "permutation indices must be aliases of integers");
+        auto* values = std::data(data);
+        const auto* raw = detail::raw(permutation.data());
+        assert(std::size(data) >= permutation.size() && "apply_permutation data is too small");
+        assert(detail::is_permutation(raw, permutation.size()) && "apply_permutation needs a bijection");
+        std::vector<bool> done(permutation.size());
+        for (std::size_t start = 0; start < permutation.size(); ++start)
+        {
+            if (done[start])
+                continue;
+            auto value = std::move(values[start]);
+            std::size_t i = start;
+            for (std::size_t next = raw[i]; next != start; i = next, next = raw[i])
+            {
+                values[i] = std::move(values[next]);
+                done[i] = true;
+            }
+            values[i] = std::move(value);
+            done[i] = true;
+        }
+    }
+
+    // inverse[permutation[i]] = i, with the same precondition as apply_permutation
+    template<typename Index>
+    std::vector<Index> invert_permutation(std::span<const Index> permutation)
+    {
+        static_assert(detail::is_index_alias_v<Index>, "permutation indices must be aliases of integers");
+        using index_type = underlying_t<Index>;
+        std::vector<Index> inverse(permutation.size());
+        const auto* raw = detail::raw(permutation.data());
+        assert(detail::is_permutation(raw, permutation.size()) && "invert_permutation needs a bijection");
+        for (std::size_t i = 0; i < permutation.size(); ++i)
+            inverse[raw[i]] = Index{ static_cast<index_type>(i) };
+        return inverse;
+    }
+}
+
+
+#ifdef STRONG_GATHER_TEST
+#include <cstdint>
+#include <vector>
+ALIAS(RowId, std::uint32_t);
+ALIAS(ColId, std::uint32_t);
+ALIAS(Price, double);
+
+int main()
+{
+    std::vector<double> src(16), dst(4);
+    std::vector<RowId> rows{ 3u, 1u, 2u, 0u };
+    std::vector<ColId> cols{ 3u, 1u, 2u, 0u };
+    std::vector<Price> prices(4);
+    { strong::gather<RowId>(src, rows, dst); }                              // ✔️
+    { strong::gather(src, std::span<const RowId>{ rows }, dst); }           // ✔️
+    { strong::gather<RowId>(src, rows, dst, 8); }                           // ✔️
+    { strong::scatter<RowId>(dst, rows, src); }                             // ✔️
+    { strong::apply_permutation<RowId>(rows, prices); }                     // ✔️
+    { std::vector<RowId> inverse = strong::invert_permutation<RowId>(rows); } // ✔️
+    { strong::gather(src, rows, dst); }                                     // ❌
+    { strong::gather<RowId>(src, cols, dst); }                              // ❌
+    { strong::gather<std::uint32_t>(src, std::vector<std::uint32_t>{}, dst); } // ❌
+    { strong::gather<RowId>(src, rows, prices); }                           // ❌
+    { std::vector<ColId> inverse = strong::invert_permutation<RowId>(rows); } // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,122 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace strong
+{
+    namespace detail
+    {
+        // Class types viewable as a std::basic_string_view of their own character type
+        template<typename T, typename = void>
+        struct string_view_of { using type = void; };
+        template<typename T>
+        struct string_view_of<T, std::enable_if_t<std::is_class_v<T>, std::void_t<typename T::value_type, typename T::traits_type>>>
+        {
+            using view = std::basic_string_view<typename T::value_type, typename T::traits_type>;
+            using type = std::conditional_t<std::is_convertible_v<const T&, view>, view, void>;
+        };
+        template<typename T> using string_view_of_t = typename string_view_of<T>::type;
+
+        // Accepted by transparent functors of Alias: Alias itself, or any non-alias viewable as its string view
+        template<typename Alias, typename Arg>
+        inline constexpr bool is_transparent_key_v = std::is_same_v<std::decay_t<Arg>, Alias>
+            || (!is_alias_v<Arg> && std::is_convertible_v<const Arg&, string_view_of_t<underlying_t<Alias>>>);
+    }
+
+    // Hash of an alias through its underlying type, transparent when the underlying type is string-like
+    template<typename Alias, typename = void>
+    struct hash
+    {
+        static_assert(is_alias_v<Alias>, "strong::hash is defined for strong aliases");
+        std::size_t operator()(const Alias& alias) const { return std::hash<underlying_t<Alias>>{}(alias); }
+    };
+    template<typename Alias>
+    struct hash<Alias, std::enable_if_t<!std::is_void_v<detail::string_view_of_t<underlying_t<Alias>>>>>
+    {
+        using is_transparent = void;
+        using view = detail::string_view_of_t<underlying_t<Alias>>;
+
+        template<typename Arg, typename = std::enable_if_t<detail::is_transparent_key_v<Alias, Arg>>>
+        std::size_t operator()(const Arg& arg) const noexcept { return std::hash<view>{}(view(arg)); }
+    };
+
+    // Equality of an alias with itself, or with raw underlying or view types when the underlying type is string-like
+    template<typename Alias, typename = void>
+    struct equal_to
+    {
+        static_assert(is_alias_v<Alias>, "strong::equal_to is defined for strong aliases");
+        bool operator()(const Alias& a, const Alias& b) const
+        {
+            return static_cast<const underlying_t<Alias>&>(a) == static_cast<const underlying_t<Alias>&>(b);
+        }
+    };
+    template<typename Alias>
+    struct equal_to<Alias, std::enable_if_t<!std::is_void_v<detail::string_view_of_t<underlying_t<Alias>>>>>
+    {
+        using is_transparent = void;
+        using view = detail::string_view_of_t<underlying_t<Alias>>;
+
+        template<typename A, typename B, typename = std::enable_if_t<detail::is_transparent_key_v<Alias, A> && detail::is_transparent_key_v<Alias, B>>>
+        bool operator()(const A& a, const B& b) const noexcept { return view(a) == view(b); }
+    };
+
+    // Unordered containers keyed by an alias, with heterogeneous lookup for string-like aliases
+    template<typename Key, typename Value>
+    using unordered_map = std::unordered_map<Key, Value, hash<Key>, equal_to<Key>>;
+    template<typename Key>
+    using unordered_set = std::unordered_set<Key, hash<Key>, equal_to<Key>>;
+}
+
+
+#ifdef STRONG_HASH_TEST
+#include <cstdint>
+#include <string>
+ALIAS(Ticker, std::string);
+ALIAS(Venue, std::string);
+ALIAS(OrderId, std::uint64_t);
+
+int main()
+{
+    using namespace std::string_view_literals;
+    strong::unordered_map<Ticker, double> prices{ { Ticker{ "ABC" }, 1. } };
+    { prices.find(Ticker{ "ABC" }); }                                   // ✔️
+    { prices.find("ABC"sv); }                                          // ✔️
+    { prices.find(std::string{ "ABC" }); }                              // ✔️
+    { prices.count("ABC"); }                                           // ✔️
+    { strong::unordered_set<OrderId> ids; ids.insert(OrderId{ 1u }); ids.count(1u); } // ✔️
+    { strong::hash<Ticker>{}("ABC"sv) == strong::hash<Ticker>{}(Ticker{ "ABC" }); } // ✔️
+    { prices.find(Venue{ "ABC" }); }                                    // ❌
+    { strong::equal_to<Ticker>{}(Ticker{ "ABC" }, Venue{ "ABC" }); }    // ❌
+    { strong::hash<std::string>{}("ABC"); }                             // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,173 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace strong
+{
+    namespace detail
+    {
+        // Index of the highest set bit, value must not be zero
+        inline unsigned log2_floor(std::uint64_t value) noexcept
+        {
+#if defined(_MSC_VER) && !defined(__clang__)
+            unsigned long index;
+            _BitScanReverse64(&index, value);
+            return static_cast<unsigned>(index);
+#else
+            return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+        }
+    }
+
+    // Log-linear histogram of one unsigned alias, with a relative error of at most 2^-(SubBucketBits-1)
+    // Values below 2^SubBucketBits have their own bucket, each further power of two is split in 2^(SubBucketBits-1) buckets.
+    // Only the owning thread records, with relaxed loads and stores; other threads may merge it concurrently without locks.
+    template<typename Value, unsigned SubBucketBits = 7>
+    class alignas(cache_line_size) hdr_histogram
+    {
+        static_assert(is_alias_v<Value> && std::is_unsigned_v<underlying_t<Value>>, "hdr_histogram values must be aliases of unsigned integers");
+        static_assert(SubBucketBits >= 1 && SubBucketBits < 32, "hdr_histogram precision out of range");
+
+        static inline constexpr unsigned half = 1u << (SubBucketBits - 1);
+
+    public:
+        static inline constexpr std::size_t bucket_count = std::size_t{ 66 - SubBucketBits } * half;
+
+        hdr_histogram() noexcept = default;
+        hdr_histogram(const hdr_histogram&) = delete;
+        hdr_histogram& operator=(const hdr_histogram&) = delete;
+
+        void record(const Value& value) noexcept { record(value, 1); }
+        void record(const Value& value, std::uint64_t count) noexcept
+        {
+            std::atomic<std::uint64_t>& counter = counts_[index(static_cast<std::uint64_t>(underlying_t<Value>{ value }))];
+            counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+        }
+
+        // Adds other's counts, other may be recording concurrently; this must not be recorded into meanwhile
+        void merge(const hdr_histogram& other) noexcept
+        {
+            for (std::size_t i = 0; i < bucket_count; ++i)
+                if (const std::uint64_t count = other.counts_[i].load(std::memory_order_relaxed))
+                    counts_[i].fetch_add(count, std::memory_order_relaxed);
+        }
+        void reset() noexcept
+        {
+            for (auto& count : counts_) count.store(0, std::memory_order_relaxed);
+        }
+
+        std::uint64_t count() const noexcept
+        {
+            std::uint64_t total = 0;
+            for (const auto& count : counts_) total += count.load(std::memory_order_relaxed);
+            return total;
+        }
+        // Smallest value equivalent to the lowest recorded one, zero when empty
+        Value min() const noexcept
+        {
+            for (std::size_t i = 0; i < bucket_count; ++i)
+                if (counts_[i].load(std::memory_order_relaxed)) return Value{ static_cast<underlying_t<Value>>(lowest(i)) };
+            return Value{ underlying_t<Value>{} };
+        }
+        // Largest value equivalent to the highest recorded one, zero when empty
+        Value max() const noexcept
+        {
+            for (std::size_t i = bucket_count; i-- > 0;)
+                if (counts_[i].load(std::memory_order_relaxed)) return Value{ static_cast<underlying_t<Value>>(highest(i)) };
+            return Value{ underlying_t<Value>{} };
+        }
+        // Largest value equivalent to the one at the given percentile in [0, 100], zero when empty
+        Value percentile(double p) const noexcept
+        {
+            const std::uint64_t total = count();
+            if (!total) return Value{ underlying_t<Value>{} };
+            const double rank = p / 100. * static_cast<double>(total);
+            std::uint64_t target = rank <= 1. ? 1 : static_cast<std::uint64_t>(rank);
+            if (static_cast<double>(target) < rank) ++target;
+            if (target > total) target = total;
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < bucket_count; ++i)
+                if ((seen += counts_[i].load(std::memory_order_relaxed)) >= target)
+                    return Value{ static_cast<underlying_t<Value>>(highest(i)) };
+            return max();
+        }
+
+    private:
+        static std::size_t index(std::uint64_t value) noexcept
+        {
+            if (value < 2 * half) return static_cast<std::size_t>(value);
+            const unsigned shift = detail::log2_floor(value) - (SubBucketBits - 1);
+            return std::size_t{ shift } * half + static_cast<std::size_t>(value >> shift);
+        }
+        static std::uint64_t lowest(std::size_t index) noexcept
+        {
+            if (index < 2 * half) return index;
+            const unsigned shift = static_cast<unsigned>(index / half) - 1;
+            return (std::uint64_t{ index % half } + half) << shift;
+        }
+        static std::uint64_t highest(std::size_t index) noexcept
+        {
+            if (index < 2 * half) return index;
+            const unsigned shift = static_cast<unsigned>(index / half) - 1;
+            return lowest(index) + ((std::uint64_t{ 1 } << shift) - 1);
+        }
+
+        std::array<std::atomic<std::uint64_t>, bucket_count> counts_{};
+    };
+}
+
+
+#ifdef STRONG_HDR_HISTOGRAM_TEST
+#include <cstdint>
+ALIAS(Nanos, std::uint64_t);
+ALIAS(Bytes, std::uint64_t);
+ALIAS(Delta, std::int64_t);
+
+int main()
+{
+    static thread_local strong::hdr_histogram<Nanos> local;
+    static strong::hdr_histogram<Nanos> total;
+    { local.record(Nanos{ 1500u }); local.record(Nanos{ 20u }, 3); }          // ✔️
+    { total.merge(local); Nanos p99 = total.percentile(99.); }               // ✔️
+    { Nanos lo = total.min(); Nanos hi = total.max(); total.reset(); }       // ✔️
+    { local.record(Bytes{ 64u }); }                                          // ❌
+    { Bytes p = total.percentile(50.); }                                     // ❌
+    { strong::hdr_histogram<Bytes> b; total.merge(b); }                      // ❌
+    { strong::hdr_histogram<Delta> d; }                                      // ❌
+    { strong::hdr_histogram<Nanos> copy = total; }                           // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,101 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <limits>
+#include <type_traits>
+
+// User-defined literal for a scalar alias, e.g. ALIAS_LITERAL(Millis, _ms) makes 250_ms a Millis
+// The literal is consteval: a value that does not fit in the underlying type does not compile.
+// A leading minus is not part of the literal: -5_x makes 5_x and then negates the underlying value, unchecked.
+#define ALIAS_LITERAL(NAME, SUFFIX) \
+consteval NAME operator"" ## SUFFIX(strong::detail::literal_arg_t<strong::underlying_t<NAME>> value)\
+{\
+	return strong::detail::make_literal<NAME>(value, strong::underlying_t<NAME>{}, std::numeric_limits<strong::underlying_t<NAME>>::max());\
+}
+
+// Same, with the literal also restricted to [MIN, MAX] at compile time
+// Since literals are never negative, negative ranges are not supported and MIN must be at least zero.
+#define ALIAS_LITERAL_RANGE(NAME, SUFFIX, MIN, MAX) \
+consteval NAME operator"" ## SUFFIX(strong::detail::literal_arg_t<strong::underlying_t<NAME>> value)\
+{\
+	static_assert((MIN) >= 0, "ALIAS_LITERAL_RANGE does not support negative bounds, literals are never negative");\
+	static_assert((MIN) <= (MAX), "ALIAS_LITERAL_RANGE requires MIN <= MAX");\
+	return strong::detail::make_literal<NAME>(value, MIN, MAX);\
+}
+
+namespace strong
+{
+    namespace detail
+    {
+        // Literal operators only take unsigned long long or long double
+        template<typename T>
+        using literal_arg_t = std::conditional_t<std::is_floating_point_v<T>, long double, unsigned long long>;
+
+        // Not constexpr: reaching it during constant evaluation is the compile error
+        inline void literal_out_of_range() {}
+
+        template<typename Alias, typename Arg, typename Bound>
+        consteval Alias make_literal(Arg value, Bound min, Bound max)
+        {
+            using T = underlying_t<Alias>;
+            static_assert(std::is_arithmetic_v<T>, "ALIAS_LITERAL requires an arithmetic alias");
+            static_assert(std::is_arithmetic_v<Bound>, "ALIAS_LITERAL_RANGE bounds must be arithmetic");
+            // Bounds are non-negative, so they compare exactly in the literal's type before narrowing
+            if (value < static_cast<Arg>(min) || value > static_cast<Arg>(max)) literal_out_of_range();
+            return Alias{ static_cast<T>(value) };
+        }
+    }
+}
+
+
+#ifdef STRONG_LITERALS_TEST
+#include <cstdint>
+ALIAS(Millis, std::int64_t);
+ALIAS(Port, std::uint16_t);
+ALIAS(Ratio, double);
+ALIAS(Celsius, std::int32_t);
+ALIAS_LITERAL(Millis, _ms)
+ALIAS_LITERAL(Port, _port)
+ALIAS_LITERAL_RANGE(Ratio, _ratio, 0.0, 1.0)
+ALIAS_LITERAL_RANGE(Millis, _timeout, 1, 60000)
+ALIAS_LITERAL_RANGE(Celsius, _celsius, -10, 100)        // ❌ negative bounds are not supported
+
+int main()
+{
+    { Millis m = 250_ms; }                      // ✔️
+    { constexpr Port p = 8080_port; }           // ✔️
+    { Ratio r = 0.25_ratio; }                   // ✔️
+    { Millis t = 500_timeout; }                 // ✔️
+    { Port p = 70000_port; }                    // ❌ out of range of std::uint16_t
+    { Ratio r = 1.5_ratio; }                    // ❌ out of range
+    { Millis t = 0_timeout; }                   // ❌ out of range
+    { Ratio r = 1_ratio; }                      // ❌ integer literal for a floating point alias
+    { Port p = 250_ms; }                        // ❌
+    { Millis m = 9223372036854775808_ms; }      // ❌ out of range of std::int64_t
+
+    return 0;
+}
+#endif
@@ -0,0 +1,211 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include "strong_morton.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+namespace strong
+{
+    namespace detail
+    {
+        template<typename Index, typename = void>
+        struct is_extent_index : std::false_type {};
+        template<typename Index>
+        struct is_extent_index<Index, std::enable_if_t<is_alias_v<Index>>> : std::is_integral<underlying_t<Index>> {};
+        template<typename Index>
+        inline constexpr bool is_extent_index_v = is_extent_index<Index>::value;
+    }
+
+    // Layout policies, mapping a multi-dimensional index to an offset in the underlying buffer
+
+    // Last index contiguous, as in C arrays
+    struct layout_right
+    {
+        template<std::size_t N>
+        static constexpr std::size_t size(const std::array<std::size_t, N>& extents) noexcept
+        {
+            std::size_t result = 1;
+            for (std::size_t d = 0; d < N; ++d) result *= extents[d];
+            return result;
+        }
+        template<std::size_t N>
+        static constexpr std::size_t offset(const std::array<std::size_t, N>& extents, const std::array<std::size_t, N>& index) noexcept
+        {
+            std::size_t result = index[0];
+            for (std::size_t d = 1; d < N; ++d) result = result * extents[d] + index[d];
+            return result;
+        }
+    };
+
+    // First index contiguous, as in Fortran and Eigen
+    struct layout_left
+    {
+        template<std::size_t N>
+        static constexpr std::size_t size(const std::array<std::size_t, N>& extents) noexcept { return layout_right::size(extents); }
+        template<std::size_t N>
+        static constexpr std::size_t offset(const std::array<std::size_t, N>& extents, const std::array<std::size_t, N>& index) noexcept
+        {
+            std::size_t result = index[N - 1];
+            for (std::size_t d = N - 1; d-- > 0;) result = result * extents[d] + index[d];
+            return result;
+        }
+    };
+
+    // Tiles of Tile elements along every dimension, tiles and the elements within them laid out right
+    // Extents are rounded up to whole tiles.
+    template<std::size_t Tile = 8>
+    struct layout_tiled
+    {
+        static_assert(Tile && !(Tile & (Tile - 1)), "layout_tiled tile size must be a power of two");
+
+        template<std::size_t N>
+        static constexpr std::size_t size(const std::array<std::size_t, N>& extents) noexcept
+        {
+            std::size_t result = 1;
+            for (std::size_t d = 0; d < N; ++d) result *= (extents[d] + Tile - 1) & ~(Tile - 1);
+            return result;
+        }
+        template<std::size_t N>
+        static constexpr std::size_t offset(const std::array<std::size_t, N>& extents, const std::array<std::size_t, N>& index) noexcept
+        {
+            std::size_t tile = 0, within = 0;
+            for (std::size_t d = 0; d < N; ++d)
+            {
+                tile = tile * ((extents[d] + Tile - 1) / Tile) + index[d] / Tile;
+                within = within * Tile + (index[d] & (Tile - 1));
+            }
+            return tile * tile_size<N>() + within;
+        }
+
+    private:
+        template<std::size_t N>
+        static constexpr std::size_t tile_size() noexcept
+        {
+            std::size_t result = 1;
+            for (std::size_t d = 0; d < N; ++d) result *= Tile;
+            return result;
+        }
+    };
+
+    // Bits of the indices interleaved along a Z-order curve, the last index taking the lowest bit
+    // Every extent is rounded up to the power of two covering the largest one.
+    struct layout_morton
+    {
+        template<std::size_t N>
+        static constexpr std::size_t size(const std::array<std::size_t, N>& extents) noexcept
+        {
+            std::size_t side = 1;
+            for (std::size_t d = 0; d < N; ++d)
+                while (side < extents[d]) side <<= 1;
+            std::size_t result = 1;
+            for (std::size_t d = 0; d < N; ++d) result *= side;
+            return result;
+        }
+        template<std::size_t N>
+        static constexpr std::size_t offset(const std::array<std::size_t, N>&, const std::array<std::size_t, N>& index) noexcept
+        {
+            std::uint64_t result = 0;
+            for (std::size_t d = 0; d < N; ++d)
+                result |= detail::spread_bits<N>(index[d]) << (N - 1 - d);
+            return static_cast<std::size_t>(result);
+        }
+    };
+
+    // Non-owning multi-dimensional view where each dimension is indexed by its own integer alias
+    // Indexing with another dimension's alias does not compile; offsets are computed by the Layout policy.
+    template<typename T, typename Layout, typename... Indices>
+    class mdspan
+    {
+        static_assert(sizeof...(Indices) > 0, "mdspan requires at least one dimension");
+        static_assert((detail::is_extent_index_v<Indices> && ...), "mdspan indices must be aliases of integers");
+
+    public:
+        using element_type = T;
+        using layout_type = Layout;
+        template<std::size_t I>
+        using index_type = std::tuple_element_t<I, std::tuple<Indices...>>;
+
+        static constexpr std::size_t rank() noexcept { return sizeof...(Indices); }
+
+        constexpr mdspan() noexcept : data_{ nullptr }, extents_{} {}
+        // data must hold at least mapped_size() elements
+        constexpr mdspan(T* data, const Indices&... extents) noexcept
+            : data_{ data }, extents_{ static_cast<std::size_t>(underlying_t<Indices>{ extents })... } {}
+
+        constexpr T& operator()(const Indices&... indices) const noexcept { return data_[offset(indices...)]; }
+#if defined(__cpp_multidimensional_subscript)
+        constexpr T& operator[](const Indices&... indices) const noexcept { return data_[offset(indices...)]; }
+#endif
+
+        template<std::size_t I>
+        constexpr index_type<I> extent() const noexcept { return index_type<I>{ static_cast<underlying_t<index_type<I>>>(extents_[I]) }; }
+        constexpr std::size_t size() const noexcept { return layout_right::size(extents_); }
+        constexpr std::size_t mapped_size() const noexcept { return Layout::size(extents_); }
+        constexpr bool empty() const noexcept { return size() == 0; }
+        constexpr T* data_handle() const noexcept { return data_; }
+
+    private:
+        constexpr std::size_t offset(const Indices&... indices) const noexcept
+        {
+            return Layout::offset(extents_, std::array<std::size_t, sizeof...(Indices)>{ static_cast<std::size_t>(underlying_t<Indices>{ indices })... });
+        }
+
+        T* data_;
+        std::array<std::size_t, sizeof...(Indices)> extents_;
+    };
+}
+
+
+#ifdef STRONG_MDSPAN_TEST
+#include <vector>
+ALIAS(TimeIdx, std::uint32_t);
+ALIAS(ChannelIdx, std::uint32_t);
+ALIAS(SampleIdx, std::uint32_t);
+ALIAS(Gain, double);
+
+int main()
+{
+    std::vector<float> buffer(4 * 8 * 16);
+    strong::mdspan<float, strong::layout_right, TimeIdx, ChannelIdx, SampleIdx> grid{ buffer.data(), TimeIdx{ 4u }, ChannelIdx{ 8u }, SampleIdx{ 16u } };
+    strong::mdspan<float, strong::layout_morton, ChannelIdx, SampleIdx> tile{ buffer.data(), ChannelIdx{ 16u }, SampleIdx{ 16u } };
+    { grid(TimeIdx{ 1u }, ChannelIdx{ 2u }, SampleIdx{ 3u }) = 1.f; }                          // ✔️
+    { SampleIdx n = grid.extent<2>(); float f = tile(ChannelIdx{ 15u }, SampleIdx{ 15u }); }   // ✔️
+    { strong::mdspan<float, strong::layout_tiled<4>, ChannelIdx, SampleIdx> t{ buffer.data(), ChannelIdx{ 8u }, SampleIdx{ 16u } }; } // ✔️
+    { strong::mdspan<const float, strong::layout_left, TimeIdx, SampleIdx> c{ buffer.data(), TimeIdx{ 4u }, SampleIdx{ 128u } }; } // ✔️
+    { grid(ChannelIdx{ 2u }, TimeIdx{ 1u }, SampleIdx{ 3u }) = 1.f; }                          // ❌
+    { grid(TimeIdx{ 1u }, ChannelIdx{ 2u }) = 1.f; }                                           // ❌
+    { TimeIdx n = grid.extent<2>(); }                                                          // ❌
+    { strong::mdspan<float, strong::layout_right, TimeIdx, Gain> g; }                          // ❌
+    { strong::mdspan<const float, strong::layout_left, TimeIdx> c{ buffer.data(), TimeIdx{ 4u } }; c(TimeIdx{ 0u }) = 1.f; } // ❌
+    { strong::layout_tiled<6> t; }                                                             // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,267 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#if defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#endif
+#endif
+#if defined(__BMI2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace strong
+{
+    namespace detail
+    {
+        // Spreads the low bits of value so that consecutive bits land Dims positions apart
+        template<std::size_t Dims>
+        constexpr std::uint64_t spread_bits(std::uint64_t value) noexcept
+        {
+            if constexpr (Dims == 1)
+                return value;
+            else if constexpr (Dims == 2)
+            {
+                value &= 0xffffffffull;
+                value = (value | (value << 16)) & 0x0000ffff0000ffffull;
+                value = (value | (value << 8))  & 0x00ff00ff00ff00ffull;
+                value = (value | (value << 4))  & 0x0f0f0f0f0f0f0f0full;
+                value = (value | (value << 2))  & 0x3333333333333333ull;
+                return (value | (value << 1))   & 0x5555555555555555ull;
+            }
+            else if constexpr (Dims == 3)
+            {
+                value &= 0x1fffffull;
+                value = (value | (value << 32)) & 0x001f00000000ffffull;
+                value = (value | (value << 16)) & 0x001f0000ff0000ffull;
+                value = (value | (value << 8))  & 0x100f00f00f00f00full;
+                value = (value | (value << 4))  & 0x10c30c30c30c30c3ull;
+                return (value | (value << 2))   & 0x1249249249249249ull;
+            }
+            else
+            {
+                std::uint64_t result = 0;
+                for (std::size_t bit = 0; bit < 64 / Dims; ++bit)
+                    result |= ((value >> bit) & 1u) << (bit * Dims);
+                return result;
+            }
+        }
+
+        // Inverse of spread_bits, gathering every Dims-th bit into the low bits
+        template<std::size_t Dims>
+        constexpr std::uint64_t compact_bits(std::uint64_t value) noexcept
+        {
+            if constexpr (Dims == 1)
+                return value;
+            else if constexpr (Dims == 2)
+            {
+                value &= 0x5555555555555555ull;
+                value = (value | (value >> 1))  & 0x3333333333333333ull;
+                value = (value | (value >> 2))  & 0x0f0f0f0f0f0f0f0full;
+                value = (value | (value >> 4))  & 0x00ff00ff00ff00ffull;
+                value = (value | (value >> 8))  & 0x0000ffff0000ffffull;
+                return (value | (value >> 16))  & 0xffffffffull;
+            }
+            else if constexpr (Dims == 3)
+            {
+                value &= 0x1249249249249249ull;
+                value = (value | (value >> 2))  & 0x10c30c30c30c30c3ull;
+                value = (value | (value >> 4))  & 0x100f00f00f00f00full;
+                value = (value | (value >> 8))  & 0x001f0000ff0000ffull;
+                value = (value | (value >> 16)) & 0x001f00000000ffffull;
+                return (value | (value >> 32))  & 0x1fffffull;
+            }
+            else
+            {
+                std::uint64_t result = 0;
+                for (std::size_t bit = 0; bit < 64 / Dims; ++bit)
+                    result |= ((value >> (bit * Dims)) & 1u) << bit;
+                return result;
+            }
+        }
+
+        // Bits of the key holding the given axis, the first axis taking the highest bit of each group
+        template<std::size_t Dims>
+        constexpr std::uint64_t morton_mask(std::size_t axis) noexcept
+        {
+            return spread_bits<Dims>(~std::uint64_t{ 0 }) << (Dims - 1 - axis);
+        }
+
+        template<std::size_t Dims>
+        inline std::uint64_t morton_deposit(std::uint64_t value, std::size_t axis) noexcept
+        {
+#if defined(__BMI2__)
+            return _pdep_u64(value, morton_mask<Dims>(axis));
+#else
+            return spread_bits<Dims>(value) << (Dims - 1 - axis);
+#endif
+        }
+        template<std::size_t Dims>
+        inline std::uint64_t morton_extract(std::uint64_t key, std::size_t axis) noexcept
+        {
+#if defined(__BMI2__)
+            return _pext_u64(key, morton_mask<Dims>(axis));
+#else
+            return compact_bits<Dims>(key >> (Dims - 1 - axis));
+#endif
+        }
+
+        template<typename Axis, typename = void>
+        struct is_morton_axis : std::false_type {};
+        template<typename Axis>
+        struct is_morton_axis<Axis, std::enable_if_t<is_alias_v<Axis>>>
+            : std::bool_constant<std::is_unsigned_v<underlying_t<Axis>> && std::is_standard_layout_v<Axis> && sizeof(Axis) == sizeof(underlying_t<Axis>)> {};
+        template<typename Axis>
+        inline constexpr bool is_morton_axis_v = is_morton_axis<Axis>::value;
+
+#if defined(__AVX2__)
+        template<std::size_t Dims>
+        inline __m256i spread_bits(__m256i value) noexcept
+        {
+            const auto step = [](__m256i v, int shift, std::uint64_t mask) { return _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi64(v, shift)), _mm256_set1_epi64x(static_cast<long long>(mask))); };
+            if constexpr (Dims == 2)
+            {
+                value = step(value, 16, 0x0000ffff0000ffffull);
+                value = step(value, 8, 0x00ff00ff00ff00ffull);
+                value = step(value, 4, 0x0f0f0f0f0f0f0f0full);
+                value = step(value, 2, 0x3333333333333333ull);
+                return step(value, 1, 0x5555555555555555ull);
+            }
+            else
+            {
+                value = _mm256_and_si256(value, _mm256_set1_epi64x(0x1fffff));
+                value = step(value, 32, 0x001f00000000ffffull);
+                value = step(value, 16, 0x001f0000ff0000ffull);
+                value = step(value, 8, 0x100f00f00f00f00full);
+                value = step(value, 4, 0x10c30c30c30c30c3ull);
+                return step(value, 2, 0x1249249249249249ull);
+            }
+        }
+#endif
+    }
+
+    // Morton (Z-order) key interleaving the bits of one unsigned alias per axis, itself a scalar alias of std::uint64_t
+    // Each axis keeps its lowest 64 / dims bits. Keys sort along a Z-order curve, so keys close in value are mostly close in space.
+    template<typename Name, typename... Axes>
+    struct morton_key : alias<std::uint64_t, Name>
+    {
+        static_assert(sizeof...(Axes) >= 2, "morton_key requires at least two axes");
+        static_assert((detail::is_morton_axis_v<Axes> && ...), "morton_key axes must be aliases of unsigned integers");
+
+        static inline constexpr std::size_t dims = sizeof...(Axes);
+        static inline constexpr unsigned bits_per_axis = 64 / dims;
+        template<std::size_t I>
+        using axis_type = std::tuple_element_t<I, std::tuple<Axes...>>;
+
+        using alias<std::uint64_t, Name>::alias;
+
+        static morton_key encode(const Axes&... axes) noexcept { return encode(std::index_sequence_for<Axes...>{}, axes...); }
+        template<std::size_t I>
+        axis_type<I> axis() const noexcept
+        {
+            return axis_type<I>{ static_cast<underlying_t<axis_type<I>>>(detail::morton_extract<dims>(static_cast<std::uint64_t>(*this), I)) };
+        }
+        std::tuple<Axes...> decode() const noexcept { return decode(std::index_sequence_for<Axes...>{}); }
+
+#if defined(__cpp_lib_span)
+        // Bulk versions over one span per axis, all spans must have the same length
+        static void encode(std::span<const Axes>... axes, std::span<morton_key> keys) noexcept
+        {
+            const std::size_t count = keys.size();
+            std::size_t i = 0;
+#if defined(__AVX2__) && !defined(__BMI2__)
+            if constexpr ((dims == 2 || dims == 3) && ((sizeof(Axes) == sizeof(std::uint32_t)) && ...))
+            {
+                for (; i + 4 <= count; i += 4)
+                {
+                    __m256i key = _mm256_setzero_si256();
+                    std::size_t axis = 0;
+                    ((key = _mm256_or_si256(key, _mm256_slli_epi64(detail::spread_bits<dims>(_mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(axes.data() + i)))), static_cast<int>(dims - 1 - axis++)))), ...);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(keys.data() + i), key);
+                }
+            }
+#endif
+            for (; i < count; ++i)
+                keys[i] = encode(axes[i]...);
+        }
+        static void decode(std::span<const morton_key> keys, std::span<Axes>... axes) noexcept
+        {
+            for (std::size_t i = 0; i < keys.size(); ++i)
+                std::tie(axes[i]...) = keys[i].decode();
+        }
+#endif
+
+    private:
+        template<std::size_t... I>
+        static morton_key encode(std::index_sequence<I...>, const Axes&... axes) noexcept
+        {
+            return morton_key{ (detail::morton_deposit<dims>(static_cast<std::uint64_t>(underlying_t<Axes>{ axes }), I) | ...) };
+        }
+        template<std::size_t... I>
+        std::tuple<Axes...> decode(std::index_sequence<I...>) const noexcept { return { axis<I>()... }; }
+    };
+}
+
+
+#ifdef STRONG_MORTON_TEST
+#include <cassert>
+#include <vector>
+ALIAS(CellX, std::uint32_t);
+ALIAS(CellY, std::uint32_t);
+ALIAS(CellZ, std::uint32_t);
+ALIAS(Epoch, std::uint32_t);
+ALIAS(Band, std::uint32_t);
+ALIAS(Level, std::int32_t);
+using CellKey = strong::morton_key<struct CellKeyName, CellX, CellY, CellZ>;
+using TileKey = strong::morton_key<struct TileKeyName, CellX, CellY>;
+using SceneKey = strong::morton_key<struct SceneKeyName, CellX, CellY, CellZ, Epoch, Band>;
+
+int main()
+{
+    std::vector<CellX> xs(16);
+    std::vector<CellY> ys(16);
+    std::vector<CellZ> zs(16);
+    std::vector<CellKey> keys(16);
+    { CellKey k = CellKey::encode(CellX{ 1u }, CellY{ 2u }, CellZ{ 3u }); CellY y = k.axis<1>(); } // ✔️
+    { auto [x, y, z] = CellKey::encode(CellX{ 1u }, CellY{ 2u }, CellZ{ 3u }).decode(); }      // ✔️
+    { CellKey a = CellKey::encode(CellX{ 1u }, CellY{ 2u }, CellZ{ 3u }); bool b = a < CellKey{ 9u }; } // ✔️
+    { CellKey::encode(xs, ys, zs, keys); CellKey::decode(keys, xs, ys, zs); }              // ✔️
+    { auto k = SceneKey::encode(CellX{ 4095u }, CellY{ 1u }, CellZ{ 2048u }, Epoch{ 7u }, Band{ 4096u + 5u }); assert(k.decode() == std::make_tuple(CellX{ 4095u }, CellY{ 1u }, CellZ{ 2048u }, Epoch{ 7u }, Band{ 5u })); } // ✔️ 12 bits per axis
+    { CellKey::encode(CellY{ 2u }, CellX{ 1u }, CellZ{ 3u }); }                            // ❌
+    { CellKey::encode(CellX{ 1u }, CellY{ 2u }); }                                         // ❌
+    { CellX x = CellKey{ 0u }.axis<1>(); }                                                 // ❌
+    { CellKey k = TileKey::encode(CellX{ 1u }, CellY{ 2u }); }                             // ❌
+    { CellKey::encode(ys, xs, zs, keys); }                                                 // ❌
+    { strong::morton_key<struct LevelKeyName, Level, CellX> k; }                           // ❌
+
+    return 0;
+}
+#endif
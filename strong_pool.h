@@ -0,0 +1,184 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace strong
+{
+    // Chunked object pool handing out 32-bit handle aliases instead of pointers
+    // Free handles are cached per thread shard and exchanged in batches with a shared free list.
+    // Objects still alive when the pool is destroyed are not destructed.
+    template<typename T, typename Handle, std::size_t ChunkSize = 4096, std::size_t CacheSlots = 64>
+    class pool
+    {
+        static_assert(is_alias_v<Handle>, "pool handles must be strong aliases");
+        static_assert(std::is_same_v<underlying_t<Handle>, std::uint32_t>, "pool handles must alias std::uint32_t");
+        static_assert(ChunkSize && !(ChunkSize & (ChunkSize - 1)), "pool chunk size must be a power of two");
+
+        static inline constexpr std::size_t batch_size = 64;
+
+        struct alignas(std::max(alignof(T), cache_line_size)) chunk { unsigned char bytes[ChunkSize * sizeof(T)]; };
+        struct alignas(cache_line_size) cache
+        {
+            std::atomic_flag           busy = ATOMIC_FLAG_INIT;
+            std::vector<std::uint32_t> free;
+        };
+        // Locks the cache of the calling thread's shard
+        class cache_lock
+        {
+        public:
+            explicit cache_lock(cache& c) noexcept : cache_{ c } { while (cache_.busy.test_and_set(std::memory_order_acquire)) std::this_thread::yield(); }
+            ~cache_lock() { cache_.busy.clear(std::memory_order_release); }
+            std::vector<std::uint32_t>* operator->() const noexcept { return &cache_.free; }
+        private:
+            cache& cache_;
+        };
+
+    public:
+        // Capacity is rounded up to a whole number of chunks, chunks themselves are allocated on demand
+        explicit pool(std::size_t capacity = std::size_t{ 1 } << 20)
+            : capacity_{ (std::min<std::size_t>(capacity, std::size_t{ 1 } << 32) + ChunkSize - 1) / ChunkSize * ChunkSize },
+              chunks_{ new std::unique_ptr<chunk>[capacity_ / ChunkSize] } {}
+        pool(const pool&) = delete;
+        pool& operator=(const pool&) = delete;
+
+        template<typename... Args>
+        Handle create(Args&&... args)
+        {
+            const Handle handle = allocate();
+            try { ::new (address(handle)) T(std::forward<Args>(args)...); }
+            catch (...) { deallocate(handle); throw; }
+            return handle;
+        }
+        void destroy(Handle handle)
+        {
+            std::launder(reinterpret_cast<T*>(address(handle)))->~T();
+            deallocate(handle);
+        }
+
+        T&       operator[](Handle handle)       noexcept { return *std::launder(reinterpret_cast<T*>(address(handle))); }
+        const T& operator[](Handle handle) const noexcept { return *std::launder(reinterpret_cast<const T*>(address(handle))); }
+
+        // Raw storage, throws std::bad_alloc once capacity is exhausted
+        Handle allocate()
+        {
+            cache_lock free{ caches_[slot_index()] };
+            if (free->empty())
+                refill(*free.operator->());
+            const std::uint32_t index = free->back();
+            free->pop_back();
+            return Handle{ index };
+        }
+        void deallocate(Handle handle)
+        {
+            cache_lock free{ caches_[slot_index()] };
+            free->push_back(handle);
+            if (free->size() >= 2 * batch_size)
+            {
+                std::lock_guard<std::mutex> lock{ mutex_ };
+                shared_.insert(shared_.end(), free->end() - batch_size, free->end());
+                free->resize(free->size() - batch_size);
+            }
+        }
+
+        std::size_t capacity() const noexcept { return capacity_; }
+
+    private:
+        unsigned char* address(std::uint32_t index) const noexcept
+        {
+            return chunks_[index / ChunkSize]->bytes + (index % ChunkSize) * sizeof(T);
+        }
+
+        // Take a batch from the shared free list, or carve never used handles
+        void refill(std::vector<std::uint32_t>& free)
+        {
+            std::lock_guard<std::mutex> lock{ mutex_ };
+            if (!shared_.empty())
+            {
+                const std::size_t n = std::min(batch_size, shared_.size());
+                free.insert(free.end(), shared_.end() - n, shared_.end());
+                shared_.resize(shared_.size() - n);
+                return;
+            }
+            if (next_ == capacity_)
+                throw std::bad_alloc{};
+            const std::size_t n = std::min(batch_size, capacity_ - next_);
+            for (std::size_t c = next_ / ChunkSize; c <= (next_ + n - 1) / ChunkSize; ++c)
+                if (!chunks_[c])
+                    chunks_[c].reset(new chunk);
+            // Pushed in reverse so that handles are handed out in increasing order
+            for (std::size_t i = next_ + n; i-- > next_;)
+                free.push_back(static_cast<std::uint32_t>(i));
+            next_ += n;
+        }
+
+        static std::size_t slot_index() noexcept
+        {
+            static thread_local const std::size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % CacheSlots;
+            return index;
+        }
+
+        const std::size_t                         capacity_;
+        std::unique_ptr<std::unique_ptr<chunk>[]> chunks_;
+        std::size_t                               next_ = 0;
+        std::vector<std::uint32_t>                shared_;
+        std::mutex                                mutex_;
+        cache                                     caches_[CacheSlots];
+    };
+}
+
+
+#ifdef STRONG_POOL_TEST
+#include <cstdint>
+#include <vector>
+ALIAS(NodeHandle, std::uint32_t);
+ALIAS(EdgeHandle, std::uint32_t);
+ALIAS(WideHandle, std::uint64_t);
+struct node { double x, y; };
+
+int main()
+{
+    { strong::pool<node, NodeHandle> p; NodeHandle h = p.create(node{ 1., 2. }); p[h].x = 3.; p.destroy(h); } // ✔️
+    { strong::pool<std::vector<double>, NodeHandle> p; auto h = p.create(16, 0.); p[h].resize(4); }       // ✔️
+    { static_assert(sizeof(NodeHandle) == 4); }                                                             // ✔️
+    { strong::pool<node, std::uint32_t> p; }                                                                // ❌
+    { strong::pool<node, WideHandle> p; }                                                                   // ❌
+    { strong::pool<node, NodeHandle> p; EdgeHandle h = p.create(); }                                        // ❌
+    { strong::pool<node, NodeHandle> p; EdgeHandle h; p[h]; }                                               // ❌
+    { strong::pool<node, NodeHandle> p; node* n = p.create(); }                                             // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,290 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+
+namespace strong
+{
+    namespace detail
+    {
+        // Uninitialized storage for a single element
+        template<typename T>
+        struct storage
+        {
+            alignas(T) unsigned char bytes[sizeof(T)];
+
+            template<typename Arg>
+            void construct(Arg&& arg) { ::new (static_cast<void*>(bytes)) T(std::forward<Arg>(arg)); }
+            void destroy() noexcept { get().~T(); }
+            T&   get() noexcept { return *std::launder(reinterpret_cast<T*>(bytes)); }
+        };
+
+        inline constexpr std::size_t next_power_of_two(std::size_t n) noexcept
+        {
+            std::size_t result = 1;
+            while (result < n) result <<= 1;
+            return result;
+        }
+
+        template<typename It, typename Alias>
+        inline constexpr bool is_iterator_of_v = std::is_same_v<typename std::iterator_traits<It>::value_type, Alias>;
+    }
+
+    // Bounded single-producer/single-consumer ring of aliases
+    template<typename Alias>
+    class spsc_queue
+    {
+        static_assert(is_alias_v<Alias>, "spsc_queue elements must be strong aliases");
+
+        struct alignas(cache_line_size) slot { detail::storage<Alias> value; };
+        // Index owned by one side, along with its last known value of the other side's index
+        struct alignas(cache_line_size) index
+        {
+            std::atomic<std::size_t> value{ 0 };
+            std::size_t              cached{ 0 };
+        };
+
+    public:
+        explicit spsc_queue(std::size_t capacity)
+            : capacity_{ detail::next_power_of_two(capacity) }, slots_{ new slot[capacity_] } {}
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+        ~spsc_queue()
+        {
+            for (std::size_t i = head_.value.load(std::memory_order_relaxed); i != tail_.value.load(std::memory_order_relaxed); ++i)
+                slots_[i & (capacity_ - 1)].value.destroy();
+        }
+
+        // Producer side
+        bool try_push(const Alias& value) { return push(value); }
+        bool try_push(Alias&& value)      { return push(std::move(value)); }
+        // Move as many elements as possible with a single publication, returns the first element not pushed
+        template<typename InputIt, typename = std::enable_if_t<detail::is_iterator_of_v<InputIt, Alias>>>
+        InputIt try_push_bulk(InputIt first, InputIt last)
+        {
+            const std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+            tail_.cached = head_.value.load(std::memory_order_acquire);
+            const std::size_t free = capacity_ - (tail - tail_.cached);
+            std::size_t n = 0;
+            for (; n < free && first != last; ++n, ++first)
+                slots_[(tail + n) & (capacity_ - 1)].value.construct(std::move(*first));
+            tail_.value.store(tail + n, std::memory_order_release);
+            return first;
+        }
+
+        // Consumer side
+        bool try_pop(Alias& out)
+        {
+            const std::size_t head = head_.value.load(std::memory_order_relaxed);
+            if (head == head_.cached && (head_.cached = tail_.value.load(std::memory_order_acquire)) == head)
+                return false;
+            auto& value = slots_[head & (capacity_ - 1)].value;
+            out = std::move(value.get());
+            value.destroy();
+            head_.value.store(head + 1, std::memory_order_release);
+            return true;
+        }
+        // Move up to max elements into out with a single release, returns the number of elements popped
+        template<typename OutputIt>
+        std::size_t try_pop_bulk(OutputIt out, std::size_t max)
+        {
+            const std::size_t head = head_.value.load(std::memory_order_relaxed);
+            if (head_.cached - head < max)
+                head_.cached = tail_.value.load(std::memory_order_acquire);
+            const std::size_t n = std::min(head_.cached - head, max);
+            for (std::size_t i = 0; i < n; ++i, ++out)
+            {
+                auto& value = slots_[(head + i) & (capacity_ - 1)].value;
+                *out = std::move(value.get());
+                value.destroy();
+            }
+            head_.value.store(head + n, std::memory_order_release);
+            return n;
+        }
+
+        std::size_t capacity() const noexcept { return capacity_; }
+
+    private:
+        template<typename Arg>
+        bool push(Arg&& value)
+        {
+            const std::size_t tail = tail_.value.load(std::memory_order_relaxed);
+            if (tail - tail_.cached == capacity_ && tail - (tail_.cached = head_.value.load(std::memory_order_acquire)) == capacity_)
+                return false;
+            slots_[tail & (capacity_ - 1)].value.construct(std::forward<Arg>(value));
+            tail_.value.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        const std::size_t        capacity_;
+        std::unique_ptr<slot[]>  slots_;
+        index                    head_; // consumer, caches tail
+        index                    tail_; // producer, caches head
+    };
+
+    // Bounded multi-producer/multi-consumer queue of aliases, after Dmitry Vyukov's design
+    template<typename Alias>
+    class mpmc_queue
+    {
+        static_assert(is_alias_v<Alias>, "mpmc_queue elements must be strong aliases");
+
+        struct alignas(cache_line_size) slot
+        {
+            std::atomic<std::size_t> sequence;
+            detail::storage<Alias>   value;
+        };
+        struct alignas(cache_line_size) index { std::atomic<std::size_t> value{ 0 }; };
+
+    public:
+        // At least two slots: with a single one, a slot's sequence cannot tell a full ring from an empty one
+        explicit mpmc_queue(std::size_t capacity)
+            : capacity_{ detail::next_power_of_two(capacity < 2 ? 2 : capacity) }, slots_{ new slot[capacity_] }
+        {
+            for (std::size_t i = 0; i < capacity_; ++i)
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+        ~mpmc_queue()
+        {
+            for (std::size_t i = dequeue_.value.load(std::memory_order_relaxed); i != enqueue_.value.load(std::memory_order_relaxed); ++i)
+                slots_[i & (capacity_ - 1)].value.destroy();
+        }
+
+        bool try_push(const Alias& value) { return push(value); }
+        bool try_push(Alias&& value)      { return push(std::move(value)); }
+        // Claim a run of free slots with a single CAS, returns the first element not pushed
+        template<typename ForwardIt, typename = std::enable_if_t<detail::is_iterator_of_v<ForwardIt, Alias>>>
+        ForwardIt try_push_bulk(ForwardIt first, ForwardIt last)
+        {
+            std::size_t pos;
+            const std::size_t n = claim(enqueue_, 0, static_cast<std::size_t>(std::distance(first, last)), pos);
+            for (std::size_t i = 0; i < n; ++i, ++first)
+            {
+                slot& s = slots_[(pos + i) & (capacity_ - 1)];
+                s.value.construct(std::move(*first));
+                s.sequence.store(pos + i + 1, std::memory_order_release);
+            }
+            return first;
+        }
+
+        bool try_pop(Alias& out) { return try_pop_bulk(&out, 1) == 1; }
+        // Claim a run of filled slots with a single CAS, returns the number of elements popped
+        template<typename OutputIt>
+        std::size_t try_pop_bulk(OutputIt out, std::size_t max)
+        {
+            std::size_t pos;
+            const std::size_t n = claim(dequeue_, 1, max, pos);
+            for (std::size_t i = 0; i < n; ++i, ++out)
+            {
+                slot& s = slots_[(pos + i) & (capacity_ - 1)];
+                *out = std::move(s.value.get());
+                s.value.destroy();
+                s.sequence.store(pos + i + capacity_, std::memory_order_release);
+            }
+            return n;
+        }
+
+        std::size_t capacity() const noexcept { return capacity_; }
+
+    private:
+        template<typename Arg>
+        bool push(Arg&& value)
+        {
+            std::size_t pos;
+            if (claim(enqueue_, 0, 1, pos) == 0)
+                return false;
+            slot& s = slots_[pos & (capacity_ - 1)];
+            s.value.construct(std::forward<Arg>(value));
+            s.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Reserve up to max consecutive slots whose sequence is ready for the given side
+        std::size_t claim(index& position, std::size_t offset, std::size_t max, std::size_t& pos)
+        {
+            pos = position.value.load(std::memory_order_relaxed);
+            while (max != 0)
+            {
+                std::size_t n = 0;
+                std::intptr_t diff = 0;
+                for (; n < max; ++n)
+                {
+                    const std::size_t sequence = slots_[(pos + n) & (capacity_ - 1)].sequence.load(std::memory_order_acquire);
+                    diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + n + offset);
+                    if (diff != 0)
+                        break;
+                }
+                if (n == 0)
+                {
+                    if (diff < 0)
+                        return 0; // full for producers, empty for consumers
+                    pos = position.value.load(std::memory_order_relaxed);
+                }
+                else if (position.value.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+                    return n;
+            }
+            return 0;
+        }
+
+        const std::size_t        capacity_;
+        std::unique_ptr<slot[]>  slots_;
+        index                    enqueue_;
+        index                    dequeue_;
+    };
+}
+
+
+#ifdef STRONG_QUEUE_TEST
+#include <cstdint>
+#include <vector>
+ALIAS(OrderId, std::uint64_t);
+ALIAS(TradeId, std::uint64_t);
+ALIAS(Frame, std::vector<std::byte>);
+
+int main()
+{
+    { strong::spsc_queue<OrderId> q(8); q.try_push(OrderId{ 1u }); }                      // ✔️
+    { strong::spsc_queue<OrderId> q(8); q.try_push(1u); }                                 // ✔️
+    { strong::spsc_queue<OrderId> q(8); OrderId o; q.try_pop(o); }                        // ✔️
+    { strong::spsc_queue<Frame> q(8); Frame f(1024); q.try_push(std::move(f)); }          // ✔️
+    { strong::mpmc_queue<Frame> q(8); std::vector<Frame> v(4); q.try_push_bulk(v.begin(), v.end()); } // ✔️
+    { strong::mpmc_queue<OrderId> q(8); std::vector<OrderId> v; q.try_pop_bulk(std::back_inserter(v), 8); } // ✔️
+    { strong::mpmc_queue<OrderId> q(1); q.try_push(1u); q.try_push(2u); }                 // ✔️ capacity rounded up to 2
+    { strong::spsc_queue<std::uint64_t> q(8); }                                           // ❌
+    { strong::spsc_queue<OrderId> q(8); q.try_push(TradeId{ 1u }); }                      // ❌
+    { strong::mpmc_queue<OrderId> q(8); TradeId t; q.try_pop(t); }                        // ❌
+    { strong::mpmc_queue<OrderId> q(8); std::vector<TradeId> v(4); q.try_push_bulk(v.begin(), v.end()); } // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,141 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace strong
+{
+    // Read-mostly cell publishing immutable versions of an alias
+    // Readers never block: they bump a per-thread counter of the current epoch and dereference the current version.
+    // Writers are serialized, swap in the new version, then wait for both epoch parities to drain before reclaiming the old one.
+    template<typename Alias, std::size_t ReaderSlots = 64>
+    class rcu_cell
+    {
+        static_assert(is_alias_v<Alias>, "rcu_cell values must be strong aliases");
+
+        struct alignas(cache_line_size) slot { std::atomic<std::size_t> readers[2] = {}; };
+
+    public:
+        // Guarded const view of a version, kept alive until the guard is destroyed
+        class read_guard
+        {
+        public:
+            read_guard(const read_guard&) = delete;
+            read_guard& operator=(const read_guard&) = delete;
+            read_guard(read_guard&& other) noexcept : counter_{ std::exchange(other.counter_, nullptr) }, value_{ other.value_ } {}
+            ~read_guard() { if (counter_) counter_->fetch_sub(1, std::memory_order_release); }
+
+            const Alias& operator*()  const noexcept { return *value_; }
+            const Alias* operator->() const noexcept { return value_; }
+            const Alias& get()        const noexcept { return *value_; }
+
+        private:
+            friend class rcu_cell;
+            read_guard(std::atomic<std::size_t>* counter, const Alias* value) noexcept : counter_{ counter }, value_{ value } {}
+
+            std::atomic<std::size_t>* counter_;
+            const Alias*              value_;
+        };
+
+        explicit rcu_cell(Alias&& value) : current_{ new Alias(std::move(value)) } {}
+        rcu_cell() : rcu_cell(Alias{}) {}
+        rcu_cell(const rcu_cell&) = delete;
+        rcu_cell& operator=(const rcu_cell&) = delete;
+        ~rcu_cell() { delete current_.load(std::memory_order_relaxed); }
+
+        read_guard read() const noexcept
+        {
+            const std::size_t epoch = epoch_.load(std::memory_order_seq_cst);
+            std::atomic<std::size_t>* counter = &slots_[slot_index()].readers[epoch & 1];
+            counter->fetch_add(1, std::memory_order_seq_cst);
+            return read_guard{ counter, current_.load(std::memory_order_seq_cst) };
+        }
+
+        // Publish a new version and reclaim the previous one once no reader can access it anymore
+        void update(Alias&& value)
+        {
+            Alias* next = new Alias(std::move(value));
+            std::lock_guard<std::mutex> lock{ writer_ };
+            Alias* previous = current_.exchange(next, std::memory_order_seq_cst);
+            synchronize();
+            delete previous;
+        }
+
+    private:
+        void synchronize()
+        {
+            for (int flip = 0; flip < 2; ++flip)
+            {
+                const std::size_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+                for (const slot& s : slots_)
+                    while (s.readers[epoch & 1].load(std::memory_order_acquire) != 0)
+                        std::this_thread::yield();
+            }
+        }
+
+        static std::size_t slot_index() noexcept
+        {
+            static thread_local const std::size_t index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % ReaderSlots;
+            return index;
+        }
+
+        std::atomic<Alias*>      current_;
+        std::atomic<std::size_t> epoch_{ 0 };
+        mutable slot             slots_[ReaderSlots];
+        std::mutex               writer_;
+    };
+}
+
+
+#ifdef STRONG_RCU_TEST
+#include <cstdint>
+#include <vector>
+struct route { std::uint32_t prefix, next_hop; };
+ALIAS(RoutingTable, std::vector<route>);
+ALIAS(Blocklist, std::vector<route>);
+ALIAS(Version, std::uint64_t);
+
+int main()
+{
+    { strong::rcu_cell<RoutingTable> c; auto r = c.read(); (void)r->empty(); }          // ✔️
+    { strong::rcu_cell<RoutingTable> c; auto r = c.read(); const RoutingTable& t = *r; } // ✔️
+    { strong::rcu_cell<RoutingTable> c; c.update(RoutingTable(16)); }                   // ✔️
+    { strong::rcu_cell<RoutingTable> c; RoutingTable t; c.update(std::move(t)); }       // ✔️
+    { strong::rcu_cell<Version> c{ 1u }; Version v = *c.read(); }                       // ✔️
+    { strong::rcu_cell<std::vector<route>> c; }                                         // ❌
+    { strong::rcu_cell<RoutingTable> c; RoutingTable t; c.update(t); }                  // ❌
+    { strong::rcu_cell<RoutingTable> c; c.update(Blocklist{}); }                        // ❌
+    { strong::rcu_cell<RoutingTable> c; c.read()->push_back({}); }                      // ❌
+    { strong::rcu_cell<RoutingTable> c; auto r = c.read(); const Blocklist& b = *r; }    // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,188 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+
+namespace strong
+{
+    // Static search index over sorted alias keys, stored in Eytzinger (breadth-first) order
+    // Lookups descend without branches and prefetch the cache line holding the descendants log2(cache_line_size / sizeof(key))
+    // levels down, 3 levels for 8-byte keys; batched lookups interleave several descents to overlap their cache misses.
+    template<typename Key, typename Position>
+    class eytzinger_index
+    {
+        static_assert(is_alias_v<Key> && std::is_scalar_v<underlying_t<Key>>, "eytzinger_index keys must be scalar aliases");
+        static_assert(is_alias_v<Position> && std::is_unsigned_v<underlying_t<Position>>, "eytzinger_index positions must be aliases of unsigned integers");
+
+        using key_type   = underlying_t<Key>;
+        using index_type = underlying_t<Position>;
+
+        static inline constexpr std::size_t batch_size = 8;
+        // Descendants of k log2(stride) levels down start at slot stride * k and share a single cache line
+        static inline constexpr std::size_t prefetch_stride = cache_line_size / sizeof(key_type);
+
+        struct aligned_delete { template<typename T> void operator()(T* p) const noexcept { ::operator delete[](p, std::align_val_t{ cache_line_size }); } };
+        template<typename T>
+        static std::unique_ptr<T[], aligned_delete> allocate(std::size_t n)
+        {
+            return std::unique_ptr<T[], aligned_delete>{ static_cast<T*>(::operator new[](n * sizeof(T), std::align_val_t{ cache_line_size })) };
+        }
+
+    public:
+        // Keys must be sorted in increasing order
+        explicit eytzinger_index(std::span<const Key> sorted)
+            : size_{ sorted.size() }, depth_{ static_cast<std::size_t>(std::bit_width(sorted.size())) },
+              keys_{ allocate<key_type>(size_ + 1) }, positions_{ allocate<index_type>(size_ + 1) }
+        {
+            std::size_t i = 0;
+            keys_[0] = key_type{};
+            build(sorted, i, 1);
+        }
+
+        // Position of the first key not less than key, or size() if there is none
+        Position lower_bound(const Key& key) const noexcept
+        {
+            const key_type x = key;
+            std::size_t k = 1;
+            for (std::size_t level = 0; level < depth_; ++level)
+            {
+                prefetch(k);
+                k = descend(k, x);
+            }
+            return result(k);
+        }
+
+        // out[i] = lower_bound(keys[i]), out must hold at least keys.size() positions
+        void lower_bound(std::span<const Key> keys, std::span<Position> out) const noexcept
+        {
+            std::size_t first = 0;
+            for (; first + batch_size <= keys.size(); first += batch_size)
+            {
+                key_type x[batch_size];
+                std::size_t k[batch_size];
+                for (std::size_t j = 0; j < batch_size; ++j)
+                {
+                    x[j] = keys[first + j];
+                    k[j] = 1;
+                }
+                for (std::size_t level = 0; level < depth_; ++level)
+                    for (std::size_t j = 0; j < batch_size; ++j)
+                    {
+                        prefetch(k[j]);
+                        k[j] = descend(k[j], x[j]);
+                    }
+                for (std::size_t j = 0; j < batch_size; ++j)
+                    out[first + j] = result(k[j]);
+            }
+            for (; first < keys.size(); ++first)
+                out[first] = lower_bound(keys[first]);
+        }
+
+        bool contains(const Key& key) const noexcept
+        {
+            const key_type x = key;
+            std::size_t k = 1;
+            for (std::size_t level = 0; level < depth_; ++level)
+                k = descend(k, x);
+            k >>= std::countr_one(k) + 1;
+            return k != 0 && keys_[k] == x;
+        }
+
+        std::size_t size() const noexcept { return size_; }
+
+    private:
+        // In-order traversal of the implicit tree assigns sorted keys to slots
+        void build(std::span<const Key> sorted, std::size_t& i, std::size_t k) noexcept
+        {
+            if (k > size_)
+                return;
+            build(sorted, i, 2 * k);
+            keys_[k] = sorted[i];
+            positions_[k] = static_cast<index_type>(i++);
+            build(sorted, i, 2 * k + 1);
+        }
+
+        // Clamped to the last slot, so that the address stays within the array near the leaves
+        void prefetch(std::size_t k) const noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(keys_.get() + std::min(prefetch_stride * k, size_));
+#endif
+        }
+
+        // Go right if the slot is less than x, nodes past the last leaf stay in place
+        std::size_t descend(std::size_t k, key_type x) const noexcept
+        {
+            const std::size_t next = 2 * k + (keys_[k <= size_ ? k : 0] < x);
+            return k <= size_ ? next : k;
+        }
+
+        // Drop the trailing right turns to recover the last node where the descent went left
+        Position result(std::size_t k) const noexcept
+        {
+            k >>= std::countr_one(k) + 1;
+            return Position{ k == 0 ? static_cast<index_type>(size_) : positions_[k] };
+        }
+
+        std::size_t                                   size_;
+        std::size_t                                   depth_;
+        std::unique_ptr<key_type[], aligned_delete>   keys_;
+        std::unique_ptr<index_type[], aligned_delete> positions_;
+    };
+}
+
+
+#ifdef STRONG_SEARCH_TEST
+#include <cstdint>
+#include <vector>
+ALIAS(Timestamp, std::int64_t);
+ALIAS(UserId, std::int64_t);
+ALIAS(Row, std::size_t);
+ALIAS(Column, std::size_t);
+
+int main()
+{
+    std::vector<Timestamp> times{ 1, 3, 5, 7 };
+    strong::eytzinger_index<Timestamp, Row> index{ times };
+    { Row r = index.lower_bound(Timestamp{ 4 }); }                              // ✔️
+    { Row r = index.lower_bound(4); }                                           // ✔️
+    { std::vector<Timestamp> q(16); std::vector<Row> r(16); index.lower_bound(q, r); } // ✔️
+    { index.contains(Timestamp{ 3 }); }                                         // ✔️
+    { strong::eytzinger_index<std::int64_t, Row> i{ std::vector<std::int64_t>{} }; } // ❌
+    { strong::eytzinger_index<Timestamp, std::size_t> i{ times }; }            // ❌
+    { index.lower_bound(UserId{ 4 }); }                                         // ❌
+    { Column c = index.lower_bound(Timestamp{ 4 }); }                           // ❌
+    { std::vector<UserId> q(16); std::vector<Row> r(16); index.lower_bound(q, r); } // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,145 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace strong
+{
+    namespace detail
+    {
+        // Hint to the CPU that the caller is spinning
+        inline void cpu_relax() noexcept
+        {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+            _mm_pause();
+#endif
+        }
+    }
+
+    // Single writer cell with lock-free readers retrying on concurrent writes
+    template<typename Alias>
+    class alignas(cache_line_size) seqlock
+    {
+        static_assert(is_alias_v<Alias>, "seqlock values must be strong aliases");
+        static_assert(std::is_trivially_copyable_v<Alias>, "seqlock values must be trivially copyable");
+
+        // Value is stored in atomic words so that readers racing with the writer are well-defined
+        static inline constexpr std::size_t word_count = (sizeof(Alias) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+        using words = std::uint64_t[word_count];
+
+    public:
+        seqlock() : seqlock(Alias{}) {}
+        explicit seqlock(const Alias& value) noexcept { write(value); }
+        seqlock(const seqlock&) = delete;
+        seqlock& operator=(const seqlock&) = delete;
+
+        // Writer side, must not be called concurrently with another store
+        void store(const Alias& value) noexcept
+        {
+            const std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+            sequence_.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            write(value);
+            sequence_.store(sequence + 2, std::memory_order_release);
+        }
+
+        // Reader side, retries until a consistent value has been read
+        Alias load() const noexcept
+        {
+            words buffer;
+            while (!try_read(buffer))
+                detail::cpu_relax();
+            Alias value;
+            std::memcpy(static_cast<void*>(&value), buffer, sizeof(Alias));
+            return value;
+        }
+        // Reader side, single attempt failing if a store is in progress
+        bool try_load(Alias& out) const noexcept
+        {
+            words buffer;
+            if (!try_read(buffer))
+                return false;
+            std::memcpy(static_cast<void*>(&out), buffer, sizeof(Alias));
+            return true;
+        }
+
+    private:
+        void write(const Alias& value) noexcept
+        {
+            words buffer{};
+            std::memcpy(buffer, static_cast<const void*>(&value), sizeof(Alias));
+            for (std::size_t i = 0; i < word_count; ++i)
+                data_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        bool try_read(words& buffer) const noexcept
+        {
+            const std::uint64_t sequence = sequence_.load(std::memory_order_acquire);
+            if (sequence & 1)
+                return false;
+            for (std::size_t i = 0; i < word_count; ++i)
+                buffer[i] = data_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return sequence_.load(std::memory_order_relaxed) == sequence;
+        }
+
+        std::atomic<std::uint64_t> sequence_{ 0 };
+        std::atomic<std::uint64_t> data_[word_count];
+    };
+}
+
+
+#ifdef STRONG_SEQLOCK_TEST
+struct quote { double bid, ask; };
+ALIAS(MidPrice, double);
+ALIAS(Spread, double);
+ALIAS(Quote, quote);
+#include <string>
+ALIAS(Name, std::string);
+
+int main()
+{
+    { strong::seqlock<MidPrice> s; s.store(MidPrice{ 1.5 }); }            // ✔️
+    { strong::seqlock<MidPrice> s; s.store(1.5); }                        // ✔️
+    { strong::seqlock<MidPrice> s; MidPrice m = s.load(); }               // ✔️
+    { strong::seqlock<MidPrice> s; double m = s.load(); }                 // ✔️
+    { strong::seqlock<Quote> s; s.store(quote{ 1., 2. }); }               // ✔️
+    { strong::seqlock<Quote> s; Quote q; s.try_load(q); }                 // ✔️
+    { strong::seqlock<double> s; }                                        // ❌
+    { strong::seqlock<Name> s; }                                          // ❌
+    { strong::seqlock<MidPrice> s; s.store(Spread{ 1.5 }); }              // ❌
+    { strong::seqlock<MidPrice> s; Spread m = s.load(); }                 // ❌
+    { strong::seqlock<MidPrice> s; Spread m; s.try_load(m); }             // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,337 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+// Macro for conveniently defining a new small vector alias holding up to N elements without allocating
+#define SMALL_VECTOR_ALIAS(NAME, N, ...) \
+struct NAME final : strong::small_vector<NAME, __VA_ARGS__, N> \
+{\
+	using strong::small_vector<NAME, __VA_ARGS__, N>::small_vector;\
+}
+
+namespace strong
+{
+    // Alias of a vector storing its first N elements inline
+    // Trivially copyable elements are relocated with memcpy when the storage grows or moves.
+    template<typename Name, typename T, std::size_t N>
+    class small_vector : public is_alias, public alias_name<Name>
+    {
+        static_assert(N > 0, "small_vector inline capacity must not be zero");
+
+        template<typename, typename, std::size_t> friend class small_vector;
+
+        template<typename Arg> static inline constexpr bool is_different_alias_v =
+            is_alias_v<Arg> && !std::is_base_of_v<alias_name<Name>, std::decay_t<Arg>>;
+        template<typename Range, typename = void>
+        struct is_range_of : std::false_type {};
+        template<typename Range>
+        struct is_range_of<Range, std::void_t<decltype(std::begin(std::declval<const Range&>()) != std::end(std::declval<const Range&>()))>>
+            : std::is_convertible<decltype(*std::begin(std::declval<const Range&>())), T> {};
+
+        static inline constexpr bool trivially_relocatable = std::is_trivially_copyable_v<T>;
+
+    public:
+        using value_type      = T;
+        using size_type       = std::size_t;
+        using iterator        = T*;
+        using const_iterator  = const T*;
+        using reference       = T&;
+        using const_reference = const T&;
+
+        small_vector() noexcept : data_{ inline_data() } {}
+        explicit small_vector(size_type count) : small_vector() { resize(count); }
+        small_vector(size_type count, const T& value) : small_vector() { resize(count, value); }
+        template<typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+        small_vector(InputIt first, InputIt last) : small_vector() { assign(first, last); }
+        small_vector(std::initializer_list<T> values) : small_vector() { assign(values.begin(), values.end()); }
+        // Implicit conversion from any range that is not an alias and whose elements implicitly convert to T,
+        // so a range of another element alias is rejected; explicit from other small vector aliases
+        template<typename Range, typename = std::enable_if_t<!is_alias_v<Range> && !std::is_integral_v<Range> && is_range_of<Range>::value>>
+        small_vector(const Range& range) : small_vector() { assign(std::begin(range), std::end(range)); }
+        template<typename OtherName, std::size_t M, typename = std::enable_if_t<!std::is_same_v<OtherName, Name>>>
+        explicit small_vector(const small_vector<OtherName, T, M>& other) : small_vector() { assign(other.begin(), other.end()); }
+
+        small_vector(const small_vector& other) : small_vector() { assign(other.begin(), other.end()); }
+        small_vector(small_vector&& other) noexcept(trivially_relocatable || std::is_nothrow_move_constructible_v<T>) : small_vector() { steal(other); }
+        small_vector& operator=(const small_vector& other)
+        {
+            if (this != &other)
+                assign(other.begin(), other.end());
+            return *this;
+        }
+        small_vector& operator=(small_vector&& other) noexcept(trivially_relocatable || std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &other)
+            {
+                clear();
+                deallocate();
+                steal(other);
+            }
+            return *this;
+        }
+        ~small_vector() { clear(); deallocate(); }
+
+        template<typename InputIt>
+        void assign(InputIt first, InputIt last)
+        {
+            clear();
+            if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+                reserve(static_cast<size_type>(std::distance(first, last)));
+            for (; first != last; ++first)
+                emplace_back(*first);
+        }
+
+        // Element access
+        T&       operator[](size_type i)       noexcept { return data_[i]; }
+        const T& operator[](size_type i) const noexcept { return data_[i]; }
+        T&       front()       noexcept { return data_[0]; }
+        const T& front() const noexcept { return data_[0]; }
+        T&       back()        noexcept { return data_[size_ - 1]; }
+        const T& back()  const noexcept { return data_[size_ - 1]; }
+        T*       data()        noexcept { return data_; }
+        const T* data()  const noexcept { return data_; }
+
+        // Iterators
+        iterator       begin()        noexcept { return data_; }
+        iterator       end()          noexcept { return data_ + size_; }
+        const_iterator begin()  const noexcept { return data_; }
+        const_iterator end()    const noexcept { return data_ + size_; }
+        const_iterator cbegin() const noexcept { return data_; }
+        const_iterator cend()   const noexcept { return data_ + size_; }
+
+        // Capacity
+        bool      empty()    const noexcept { return size_ == 0; }
+        size_type size()     const noexcept { return size_; }
+        size_type capacity() const noexcept { return capacity_; }
+        bool      is_inline() const noexcept { return data_ == inline_data(); }
+        void reserve(size_type capacity)
+        {
+            if (capacity > capacity_)
+                relocate(capacity);
+        }
+        void shrink_to_fit()
+        {
+            if (!is_inline() && size_ < capacity_)
+                relocate(size_);
+        }
+
+        // Modifiers
+        template<typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            if (size_ == capacity_)
+            {
+                // Arguments may refer to elements of this vector, construct before relocating them
+                T value(std::forward<Args>(args)...);
+                relocate(capacity_ * 2);
+                return *::new (static_cast<void*>(data_ + size_++)) T(std::move(value));
+            }
+            return *::new (static_cast<void*>(data_ + size_++)) T(std::forward<Args>(args)...);
+        }
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+        void pop_back() noexcept { data_[--size_].~T(); }
+        iterator insert(const_iterator position, T value)
+        {
+            const size_type offset = static_cast<size_type>(position - data_);
+            emplace_back(std::move(value));
+            std::rotate(data_ + offset, data_ + size_ - 1, data_ + size_);
+            return data_ + offset;
+        }
+        iterator erase(const_iterator position)
+        {
+            iterator it = data_ + (position - data_);
+            std::move(it + 1, end(), it);
+            pop_back();
+            return it;
+        }
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            iterator it = data_ + (first - data_);
+            if (first == last)
+                return it;
+            const iterator new_end = std::move(it + (last - first), end(), it);
+            while (end() != new_end)
+                pop_back();
+            return it;
+        }
+        void resize(size_type count)
+        {
+            reserve(count);
+            while (size_ < count)
+                ::new (static_cast<void*>(data_ + size_++)) T();
+            while (size_ > count)
+                pop_back();
+        }
+        void resize(size_type count, const T& value)
+        {
+            reserve(count);
+            while (size_ < count)
+                ::new (static_cast<void*>(data_ + size_++)) T(value);
+            while (size_ > count)
+                pop_back();
+        }
+        void clear() noexcept
+        {
+            std::destroy(data_, data_ + size_);
+            size_ = 0;
+        }
+
+        // Comparison operators
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator==(const Arg& arg) const { return std::equal(begin(), end(), std::begin(arg), std::end(arg)); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator!=(const Arg& arg) const { return !(*this == arg); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator< (const Arg& arg) const { return std::lexicographical_compare(begin(), end(), std::begin(arg), std::end(arg)); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator<=(const Arg& arg) const { return !std::lexicographical_compare(std::begin(arg), std::end(arg), begin(), end()); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator> (const Arg& arg) const { return std::lexicographical_compare(std::begin(arg), std::end(arg), begin(), end()); }
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        bool operator>=(const Arg& arg) const { return !std::lexicographical_compare(begin(), end(), std::begin(arg), std::end(arg)); }
+#ifdef STRONG_ALIAS_THREE_WAY_COMPARISON
+        template<typename Arg, std::enable_if_t<!is_different_alias_v<Arg>, int> = 0>
+        auto operator<=>(const Arg& arg) const -> decltype(std::lexicographical_compare_three_way(std::declval<const T*>(), std::declval<const T*>(), std::begin(arg), std::end(arg)))
+        {
+            return std::lexicographical_compare_three_way(begin(), end(), std::begin(arg), std::end(arg));
+        }
+#endif
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator==(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator!=(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator< (const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator<=(const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator> (const Arg& arg) const = delete;
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        bool operator>=(const Arg& arg) const = delete;
+#ifdef STRONG_ALIAS_THREE_WAY_COMPARISON
+        template<typename Arg, std::enable_if_t<is_different_alias_v<Arg>, int> = 0>
+        void operator<=>(const Arg& arg) const = delete;
+#endif
+
+    private:
+        T*       inline_data()       noexcept { return std::launder(reinterpret_cast<T*>(inline_)); }
+        const T* inline_data() const noexcept { return std::launder(reinterpret_cast<const T*>(inline_)); }
+
+        // Move elements from source to uninitialized destination and destroy the sources
+        static void relocate(T* source, size_type count, T* destination) noexcept(trivially_relocatable || std::is_nothrow_move_constructible_v<T>)
+        {
+            if constexpr (trivially_relocatable)
+            {
+                if (count)
+                    std::memcpy(static_cast<void*>(destination), static_cast<const void*>(source), count * sizeof(T));
+            }
+            else
+            {
+                std::uninitialized_move(source, source + count, destination);
+                std::destroy(source, source + count);
+            }
+        }
+        void relocate(size_type capacity)
+        {
+            T* storage = capacity <= N ? inline_data() : std::allocator<T>{}.allocate(capacity);
+            if (storage == data_)
+                return;
+            relocate(data_, size_, storage);
+            deallocate();
+            data_ = storage;
+            capacity_ = std::max(capacity, N);
+        }
+        void deallocate() noexcept
+        {
+            if (!is_inline())
+                std::allocator<T>{}.deallocate(data_, capacity_);
+            data_ = inline_data();
+            capacity_ = N;
+        }
+        // Take the heap buffer of other, or relocate its inline elements
+        void steal(small_vector& other)
+        {
+            if (other.is_inline())
+                relocate(other.data_, other.size_, data_);
+            else
+            {
+                data_ = other.data_;
+                capacity_ = other.capacity_;
+                other.data_ = other.inline_data();
+                other.capacity_ = N;
+            }
+            size_ = std::exchange(other.size_, 0);
+        }
+
+        T*        data_;
+        size_type size_ = 0;
+        size_type capacity_ = N;
+        alignas(T) unsigned char inline_[N * sizeof(T)];
+    };
+}
+
+
+#ifdef STRONG_SMALL_VECTOR_TEST
+#include <cstdint>
+#include <string>
+#include <vector>
+ALIAS(TagId, std::uint32_t);
+ALIAS(UserId, std::uint32_t);
+SMALL_VECTOR_ALIAS(Tags, 8, TagId);
+SMALL_VECTOR_ALIAS(Labels, 8, TagId);
+SMALL_VECTOR_ALIAS(Names, 4, std::string);
+
+int main()
+{
+    { Tags t; t.push_back(TagId{ 1u }); t.push_back(2u); }                // ✔️
+    { Tags t{ TagId{ 1u }, TagId{ 2u } }; for (TagId& id : t) id += 1u; } // ✔️
+    { Tags t = std::vector<TagId>(16); t.is_inline(); }                  // ✔️
+    { Names n(3, "x"); n.emplace_back(16, 'y'); n.erase(n.begin()); }     // ✔️
+    { Tags t; Labels l{ t }; }                                            // ✔️
+    { Tags a; Tags b; a == b; a < b; a <= b; a > b; a >= b; }             // ✔️
+    { Tags a; std::vector<TagId> v; a >= v; a > v; }                      // ✔️
+    { Tags a; Tags b; a <=> b; }                                          // ✔️ C++20
+    { Tags t; t.push_back(UserId{ 1u }); }                                // ❌
+    { Tags t; Labels l = t; }                                             // ❌
+    { Tags t; Labels l; l = t; }                                          // ❌
+    { Tags t; Labels l; t == l; }                                         // ❌
+    { Tags t; Labels l; t >= l; }                                         // ❌
+    { Tags t; Labels l; t <=> l; }                                        // ❌
+    { Tags t; [](Labels) {}(t); }                                         // ❌
+    { Tags t = std::vector<UserId>(2); }                                  // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,158 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace strong
+{
+    // Component storage keyed by an entity id alias
+    // A sparse array maps ids to positions in dense, tightly packed arrays of entities and components.
+    // Positions share the id type and its maximum marks absent ids, so ids and the entity count both stay below that maximum.
+    template<typename Entity, typename Component>
+    class sparse_set
+    {
+        static_assert(is_alias_v<Entity> && std::is_unsigned_v<underlying_t<Entity>>, "sparse_set entities must be aliases of unsigned integers");
+        static_assert(is_alias_v<Component>, "sparse_set components must be strong aliases");
+
+        using index_type = underlying_t<Entity>;
+        static inline constexpr index_type npos = std::numeric_limits<index_type>::max();
+
+    public:
+        using entity_type    = Entity;
+        using component_type = Component;
+
+        // Insert or overwrite the component of an entity
+        Component& insert(Entity entity, Component component)
+        {
+            const index_type id = entity;
+            assert(id < npos && "sparse_set ids must be below the maximum of their type");
+            if (id >= sparse_.size())
+                sparse_.resize(static_cast<std::size_t>(id) + 1, npos);
+            if (sparse_[id] != npos)
+                return components_[sparse_[id]] = std::move(component);
+            assert(dense_.size() < npos && "sparse_set is full: its next position would read as absent");
+            sparse_[id] = static_cast<index_type>(dense_.size());
+            dense_.push_back(entity);
+            components_.push_back(std::move(component));
+            return components_.back();
+        }
+
+        // Swap the last element into the hole so that storage stays packed
+        bool erase(Entity entity)
+        {
+            const index_type id = entity;
+            if (id >= sparse_.size() || sparse_[id] == npos)
+                return false;
+            const index_type position = sparse_[id];
+            const index_type last = dense_.back();
+            dense_[position] = dense_.back();
+            components_[position] = std::move(components_.back());
+            sparse_[last] = position;
+            sparse_[id] = npos;
+            dense_.pop_back();
+            components_.pop_back();
+            return true;
+        }
+
+        bool contains(Entity entity) const noexcept
+        {
+            const index_type id = entity;
+            return id < sparse_.size() && sparse_[id] != npos;
+        }
+        Component*       find(Entity entity)       noexcept { return contains(entity) ? &components_[sparse_[entity]] : nullptr; }
+        const Component* find(Entity entity) const noexcept { return contains(entity) ? &components_[sparse_[entity]] : nullptr; }
+        // Entity must be contained
+        Component&       operator[](Entity entity)       noexcept { return components_[sparse_[entity]]; }
+        const Component& operator[](Entity entity) const noexcept { return components_[sparse_[entity]]; }
+
+        std::size_t size()  const noexcept { return dense_.size(); }
+        bool        empty() const noexcept { return dense_.empty(); }
+        void        clear() noexcept { sparse_.clear(); dense_.clear(); components_.clear(); }
+
+        // Packed arrays, entities()[i] owns components()[i]
+        const std::vector<Entity>&    entities()   const noexcept { return dense_; }
+        std::vector<Component>&       components()       noexcept { return components_; }
+        const std::vector<Component>& components() const noexcept { return components_; }
+        auto begin()       noexcept { return components_.begin(); }
+        auto end()         noexcept { return components_.end(); }
+        auto begin() const noexcept { return components_.begin(); }
+        auto end()   const noexcept { return components_.end(); }
+
+    private:
+        std::vector<index_type> sparse_;
+        std::vector<Entity>     dense_;
+        std::vector<Component>  components_;
+    };
+
+    // Call f(entity, components...) for every entity present in all sets, iterating over the smallest one
+    // Sets must not be modified from within f.
+    template<typename F, typename Entity, typename... Components>
+    void join(F&& f, sparse_set<Entity, Components>&... sets)
+    {
+        static_assert(sizeof...(Components) > 0, "join requires at least one set");
+        const std::vector<Entity>* smallest = nullptr;
+        ((smallest = (!smallest || sets.size() < smallest->size()) ? &sets.entities() : smallest), ...);
+        for (const Entity& entity : *smallest)
+            if ((sets.contains(entity) && ...))
+                f(entity, sets[entity]...);
+    }
+}
+
+
+#ifdef STRONG_SPARSE_SET_TEST
+#include <cstdint>
+#include <Eigen/Dense>
+ALIAS(EntityId, std::uint32_t);
+ALIAS(BodyId, std::uint32_t);
+ALIAS(TileId, std::uint8_t);
+ALIAS(Position, Eigen::Vector3d);
+ALIAS(Velocity, Eigen::Vector3d);
+ALIAS(Mass, double);
+
+int main()
+{
+    using positions = strong::sparse_set<EntityId, Position>;
+    using velocities = strong::sparse_set<EntityId, Velocity>;
+    { positions p; p.insert(EntityId{ 1u }, Position{ 0., 0., 0. }); }                          // ✔️
+    { strong::sparse_set<EntityId, Mass> m; m.insert(1u, 2.5); m.erase(1u); }                   // ✔️
+    { strong::sparse_set<EntityId, Mass> m; Mass* x = m.find(EntityId{ 1u }); }                 // ✔️
+    { strong::sparse_set<TileId, Mass> m; for (unsigned i = 0; i < 255; ++i) m.insert(TileId{ std::uint8_t(254 - i) }, 1.); } // ✔️ ids below 255, at most 255 tiles
+    { positions p; for (Position& x : p) x.setZero(); }                                         // ✔️
+    { positions p; velocities v; strong::join([](EntityId, Position& x, const Velocity& dx) { x += dx * 0.1; }, p, v); } // ✔️
+    { strong::sparse_set<EntityId, Eigen::Vector3d> p; }                                        // ❌
+    { strong::sparse_set<std::uint32_t, Position> p; }                                          // ❌
+    { positions p; p.insert(EntityId{ 1u }, Velocity{ 0., 0., 0. }); }                          // ❌
+    { positions p; p.contains(BodyId{ 1u }); }                                                  // ❌
+    { positions p; velocities v; strong::join([](EntityId, Velocity& x, const Position& dx) { x += dx * 0.1; }, p, v); } // ❌
+    { positions p; strong::sparse_set<BodyId, Velocity> v; strong::join([](EntityId, Position&, const Velocity&) {}, p, v); } // ❌
+
+    return 0;
+}
+#endif
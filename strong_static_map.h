@@ -0,0 +1,198 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace strong
+{
+    namespace detail
+    {
+        template<typename Key>
+        inline constexpr bool is_static_key_v = is_alias_v<Key> && std::is_integral_v<underlying_t<Key>>;
+
+        inline constexpr std::size_t static_map_size(std::size_t n) noexcept
+        {
+            std::size_t result = 1;
+            while (result < n) result <<= 1;
+            return result;
+        }
+
+        inline constexpr std::uint64_t mix(std::uint64_t x) noexcept
+        {
+            x ^= x >> 33; x *= 0xff51afd7ed558ccdull;
+            x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ull;
+            return x ^ (x >> 33);
+        }
+
+        // Not constexpr: reaching them while building a static_map in a constant expression is the compile error,
+        // and a map built at runtime asserts instead
+        inline void duplicate_static_map_key() { assert(!"static_map keys must be unique"); }
+        inline void static_map_pilot_not_found() { assert(!"static_map found no perfect hash for its keys"); }
+    }
+
+    // Immutable map from integer alias constants, built at compile time with a perfect hash
+    // Keys are hashed to buckets, each bucket has a pilot chosen so that its keys land in distinct free slots;
+    // a lookup reads the pilot and then probes exactly one slot.
+    template<typename Key, typename Value, std::size_t N>
+    class static_map
+    {
+        static_assert(detail::is_static_key_v<Key>, "static_map keys must be aliases of integers");
+        static_assert(N > 0, "static_map requires at least one entry");
+
+    public:
+        static inline constexpr std::size_t slot_count   = detail::static_map_size(2 * N);
+        static inline constexpr std::size_t bucket_count = detail::static_map_size((N + 1) / 2);
+
+        constexpr explicit static_map(const std::pair<Key, Value>(&entries)[N]) : keys_{}, values_{}, pilots_{}
+        {
+            std::array<std::uint64_t, N> hashes{};
+            std::array<std::size_t, N> members{};
+            std::array<std::size_t, bucket_count + 1> starts{};
+            std::array<std::size_t, bucket_count> order{};
+            std::array<std::size_t, slot_count> slots{};
+            std::array<bool, slot_count> taken{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                hashes[i] = hash(entries[i].first);
+                ++starts[bucket(hashes[i]) + 1];
+            }
+            // Group entries by bucket, then place the largest buckets first while most slots are free
+            for (std::size_t b = 0; b < bucket_count; ++b) starts[b + 1] += starts[b];
+            std::array<std::size_t, bucket_count> fill{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                // Equal keys share a bucket, so duplicates only need checking within it
+                const std::size_t b = bucket(hashes[i]);
+                for (std::size_t m = starts[b]; m < starts[b] + fill[b]; ++m)
+                    if (entries[members[m]].first == entries[i].first) detail::duplicate_static_map_key();
+                members[starts[b] + fill[b]++] = i;
+            }
+            for (std::size_t b = 0; b < bucket_count; ++b) order[b] = b;
+            for (std::size_t b = 1; b < bucket_count; ++b)
+                for (std::size_t c = b; c > 0 && fill[order[c - 1]] < fill[order[c]]; --c)
+                {
+                    const std::size_t larger = order[c];
+                    order[c] = order[c - 1];
+                    order[c - 1] = larger;
+                }
+
+            for (std::size_t b : order)
+            {
+                if (!fill[b]) break;
+                for (std::uint32_t pilot = 0;; ++pilot)
+                {
+                    if (pilot == max_pilot) { detail::static_map_pilot_not_found(); break; }
+                    bool fits = true;
+                    for (std::size_t m = starts[b]; m < starts[b + 1] && fits; ++m)
+                    {
+                        slots[m - starts[b]] = slot(hashes[members[m]], pilot);
+                        fits = !taken[slots[m - starts[b]]];
+                        for (std::size_t k = starts[b]; k < m && fits; ++k)
+                            fits = slots[k - starts[b]] != slots[m - starts[b]];
+                    }
+                    if (!fits) continue;
+                    pilots_[b] = pilot;
+                    for (std::size_t m = starts[b]; m < starts[b + 1]; ++m)
+                    {
+                        const std::size_t s = slots[m - starts[b]];
+                        taken[s] = true;
+                        keys_[s] = entries[members[m]].first;
+                        values_[s] = entries[members[m]].second;
+                    }
+                    break;
+                }
+            }
+            // Free slots hold the first key, which hashes to its own slot and therefore never matches there
+            for (std::size_t s = 0; s < slot_count; ++s)
+                if (!taken[s]) keys_[s] = entries[0].first;
+        }
+
+        static constexpr std::size_t size() noexcept { return N; }
+        constexpr bool contains(const Key& key) const noexcept { return find(key) != nullptr; }
+        constexpr const Value* find(const Key& key) const noexcept
+        {
+            const std::uint64_t h = hash(key);
+            const std::size_t s = slot(h, pilots_[bucket(h)]);
+            return keys_[s] == key ? &values_[s] : nullptr;
+        }
+        constexpr std::optional<Value> get(const Key& key) const
+        {
+            if (const Value* value = find(key)) return *value;
+            return std::nullopt;
+        }
+
+    private:
+        static inline constexpr std::uint32_t max_pilot = 1u << 20;
+
+        static constexpr std::uint64_t hash(const Key& key) noexcept { return detail::mix(static_cast<std::uint64_t>(underlying_t<Key>{ key })); }
+        static constexpr std::size_t bucket(std::uint64_t hash) noexcept { return static_cast<std::size_t>(hash & (bucket_count - 1)); }
+        static constexpr std::size_t slot(std::uint64_t hash, std::uint32_t pilot) noexcept
+        {
+            return static_cast<std::size_t>(detail::mix(hash ^ (pilot * 0x9e3779b97f4a7c15ull)) & (slot_count - 1));
+        }
+
+        std::array<Key, slot_count> keys_;
+        std::array<Value, slot_count> values_;
+        std::array<std::uint32_t, bucket_count> pilots_;
+    };
+
+    // constexpr auto m = strong::make_static_map<MsgType, int>({ { MsgType{ 1 }, 10 }, { MsgType{ 7 }, 70 } });
+    template<typename Key, typename Value, std::size_t N>
+    constexpr static_map<Key, Value, N> make_static_map(const std::pair<Key, Value>(&entries)[N])
+    {
+        return static_map<Key, Value, N>{ entries };
+    }
+}
+
+
+#ifdef STRONG_STATIC_MAP_TEST
+#include <cstdint>
+ALIAS(MsgType, std::uint16_t);
+ALIAS(Channel, std::uint16_t);
+ALIAS(Price, double);
+constexpr auto handlers = strong::make_static_map<MsgType, int>({ { MsgType{ u'A' }, 1 }, { MsgType{ u'D' }, 2 }, { MsgType{ u'E' }, 3 }, { MsgType{ u'X' }, 4 } });
+
+int main()
+{
+    { static_assert(*handlers.find(MsgType{ u'D' }) == 2); }                       // ✔️
+    { static_assert(!handlers.contains(MsgType{ u'Z' })); }                        // ✔️
+    { std::optional<int> h = handlers.get(MsgType{ u'X' }); }                      // ✔️
+    { handlers.find(u'E'); }                                                       // ✔️
+    { handlers.find(Channel{ u'E' }); }                                            // ❌
+    { constexpr auto m = strong::make_static_map<MsgType, int>({ { MsgType{ u'B' }, 1 }, { MsgType{ u'B' }, 2 } }); } // ❌ duplicate key
+    { auto m = strong::make_static_map<MsgType, int>({ { MsgType{ u'B' }, 1 } }); }    // ✔️ built at runtime, asserts on duplicate keys
+    { constexpr auto m = strong::make_static_map<Price, int>({ { Price{ 1. }, 1 } }); } // ❌
+    { constexpr auto m = strong::make_static_map<std::uint16_t, int>({ { 1, 1 } }); } // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,174 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace strong
+{
+    namespace detail
+    {
+        template<typename T, typename... Ts>
+        struct index_of;
+        template<typename T, typename... Ts>
+        struct index_of<T, T, Ts...> : std::integral_constant<std::size_t, 0> {};
+        template<typename T, typename U, typename... Ts>
+        struct index_of<T, U, Ts...> : std::integral_constant<std::size_t, 1 + index_of<T, Ts...>::value> {};
+
+        template<typename T, typename... Ts>
+        inline constexpr bool is_one_of_v = (std::is_same_v<T, Ts> || ...);
+
+        template<typename... Ts>
+        inline constexpr bool are_distinct_v = true;
+        template<typename T, typename... Ts>
+        inline constexpr bool are_distinct_v<T, Ts...> = !is_one_of_v<T, Ts...> && are_distinct_v<Ts...>;
+
+        template<typename Alias, typename = void>
+        struct is_packable_alias : std::false_type {};
+        template<typename Alias>
+        struct is_packable_alias<Alias, std::enable_if_t<is_alias_v<Alias>>>
+            : std::bool_constant<(std::is_integral_v<underlying_t<Alias>> || std::is_pointer_v<underlying_t<Alias>>)
+                                 && sizeof(underlying_t<Alias>) <= sizeof(std::uint64_t)> {};
+
+        inline constexpr unsigned bit_width(std::size_t n) noexcept
+        {
+            unsigned width = 0;
+            for (; n; n >>= 1) ++width;
+            return width;
+        }
+    }
+
+    // One of several scalar aliases, packed in a single 64-bit word with the discriminator in the high bits
+    // Values must fit in the remaining payload_bits, which debug builds assert (a compile error in constant expressions);
+    // signed values are sign-extended when read back. With up to two alternatives that is 63 bits, up to four 62, and so on.
+    template<typename... Aliases>
+    class tagged_union
+    {
+        static_assert(sizeof...(Aliases) > 0, "tagged_union requires at least one alternative");
+        static_assert((detail::is_packable_alias<Aliases>::value && ...), "tagged_union alternatives must be aliases of integers or pointers");
+        static_assert(detail::are_distinct_v<Aliases...>, "tagged_union alternatives must be distinct");
+
+    public:
+        static inline constexpr unsigned tag_bits     = detail::bit_width(sizeof...(Aliases) - 1) ? detail::bit_width(sizeof...(Aliases) - 1) : 1;
+        static inline constexpr unsigned payload_bits = 64 - tag_bits;
+        static inline constexpr std::uint64_t payload_mask = (std::uint64_t{ 1 } << payload_bits) - 1;
+
+        constexpr tagged_union() noexcept : word_{ 0 } {}
+        // Implicit from any alternative, but neither from raw values nor from other aliases
+        template<typename Alias, typename = std::enable_if_t<detail::is_one_of_v<Alias, Aliases...>>>
+        constexpr tagged_union(const Alias& value) noexcept
+            : word_{ (std::uint64_t{ detail::index_of<Alias, Aliases...>::value } << payload_bits) | (encode(value) & payload_mask) }
+        {
+            assert(decode<Alias>(word_) == value && "tagged_union value does not fit in payload_bits");
+        }
+
+        constexpr std::size_t index() const noexcept { return static_cast<std::size_t>(word_ >> payload_bits); }
+        template<typename Alias>
+        constexpr bool holds() const noexcept
+        {
+            static_assert(detail::is_one_of_v<Alias, Aliases...>, "not an alternative of this tagged_union");
+            return index() == detail::index_of<Alias, Aliases...>::value;
+        }
+        // Alias must be the held alternative
+        template<typename Alias>
+        constexpr Alias get() const noexcept
+        {
+            static_assert(detail::is_one_of_v<Alias, Aliases...>, "not an alternative of this tagged_union");
+            assert(holds<Alias>() && "tagged_union does not hold this alternative");
+            return decode<Alias>(word_);
+        }
+
+        // Call f with the held alternative through a table of one function per alternative
+        template<typename F>
+        constexpr decltype(auto) visit(F&& f) const
+        {
+            using result = std::common_type_t<std::invoke_result_t<F&&, const Aliases&>...>;
+            static_assert((std::is_same_v<result, std::invoke_result_t<F&&, const Aliases&>> && ...), "visitor must return the same type for every alternative");
+            constexpr result(*table[])(F&&, std::uint64_t) = { &call<Aliases, F, result>... };
+            return table[index()](std::forward<F>(f), word_);
+        }
+
+        constexpr std::uint64_t raw() const noexcept { return word_; }
+        constexpr bool operator==(const tagged_union& other) const noexcept { return word_ == other.word_; }
+        constexpr bool operator!=(const tagged_union& other) const noexcept { return word_ != other.word_; }
+
+    private:
+        template<typename Alias>
+        static constexpr std::uint64_t encode(const Alias& alias) noexcept
+        {
+            const underlying_t<Alias> value = alias;
+            if constexpr (std::is_pointer_v<underlying_t<Alias>>) return reinterpret_cast<std::uintptr_t>(value);
+            else return static_cast<std::uint64_t>(value);
+        }
+        template<typename Alias>
+        static constexpr Alias decode(std::uint64_t word) noexcept
+        {
+            using T = underlying_t<Alias>;
+            if constexpr (std::is_pointer_v<T>)
+                return Alias{ reinterpret_cast<T>(static_cast<std::uintptr_t>(word & payload_mask)) };
+            else if constexpr (std::is_signed_v<T>)
+                return Alias{ static_cast<T>(static_cast<std::int64_t>(word << tag_bits) >> tag_bits) };
+            else
+                return Alias{ static_cast<T>(word & payload_mask) };
+        }
+        template<typename Alias, typename F, typename R>
+        static constexpr R call(F&& f, std::uint64_t word) { return std::forward<F>(f)(static_cast<const Alias&>(decode<Alias>(word))); }
+
+        std::uint64_t word_;
+    };
+}
+
+
+#ifdef STRONG_TAGGED_UNION_TEST
+#include <cstdint>
+ALIAS(OrderId, std::uint64_t);
+ALIAS(TradeId, std::uint64_t);
+ALIAS(QuoteId, std::uint64_t);
+ALIAS(Offset, std::int32_t);
+ALIAS(Price, double);
+
+int main()
+{
+    using event_id = strong::tagged_union<OrderId, TradeId, QuoteId>;
+    { static_assert(sizeof(event_id) == 8); }                                           // ✔️
+    { event_id e = OrderId{ 42u }; e.holds<OrderId>(); OrderId o = e.get<OrderId>(); }  // ✔️
+    { event_id e = TradeId{ 42u }; e.visit([](auto id) { return std::uint64_t{ id }; }); } // ✔️
+    { strong::tagged_union<OrderId, Offset> e = Offset{ -1 }; e.get<Offset>() == -1; }  // ✔️
+    { constexpr event_id e = OrderId{ (1ull << 62) + 7 }; }                             // ❌ does not fit in payload_bits
+    { constexpr event_id e = OrderId{ 42u }; constexpr TradeId t = e.get<TradeId>(); }  // ❌ not the held alternative
+    { event_id e = 42u; }                                                               // ❌
+    { event_id e = Offset{ 1 }; }                                                       // ❌
+    { event_id e; e.get<Offset>(); }                                                    // ❌
+    { event_id e; TradeId t = e.get<OrderId>(); }                                      // ❌
+    { strong::tagged_union<OrderId, Price> e; }                                         // ❌
+    { strong::tagged_union<OrderId, OrderId> e; }                                       // ❌
+
+    return 0;
+}
+#endif
@@ -0,0 +1,144 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2020 Fabien Péan
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#include "strong_alias.h"
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define STRONG_HAS_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define STRONG_HAS_RDTSC 1
+#else
+#define STRONG_HAS_RDTSC 0
+#endif
+
+namespace strong
+{
+    ALIAS(cycles, std::uint64_t);
+    ALIAS(nanos, std::uint64_t);
+
+    // Clock reading the CPU time stamp counter, falling back to steady_clock nanoseconds where there is none
+    // Cycles convert to nanoseconds with a 32.32 fixed-point multiply, calibrated once against steady_clock.
+    // Call calibrate() at startup to keep the calibration pause off measured paths.
+    class tsc_clock
+    {
+    public:
+        static cycles now() noexcept
+        {
+#if STRONG_HAS_RDTSC
+            return cycles{ static_cast<std::uint64_t>(__rdtsc()) };
+#else
+            return cycles{ static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()) };
+#endif
+        }
+        // Waits for earlier instructions to complete before reading, for the end of a measured interval
+        static cycles now_ordered() noexcept
+        {
+#if STRONG_HAS_RDTSC
+            unsigned int aux;
+            return cycles{ static_cast<std::uint64_t>(__rdtscp(&aux)) };
+#else
+            return now();
+#endif
+        }
+
+        // Whether the counter runs at a constant rate regardless of frequency scaling and sleep states
+        static bool is_invariant() noexcept
+        {
+#if STRONG_HAS_RDTSC && defined(_MSC_VER)
+            int regs[4];
+            __cpuid(regs, 0x80000000);
+            if (static_cast<unsigned int>(regs[0]) < 0x80000007u) return false;
+            __cpuid(regs, 0x80000007);
+            return (regs[3] >> 8) & 1;
+#elif STRONG_HAS_RDTSC
+            unsigned int eax, ebx, ecx, edx;
+            if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+            return (edx >> 8) & 1;
+#else
+            return true;
+#endif
+        }
+
+        static std::uint64_t calibrate() noexcept
+        {
+            static const std::uint64_t scale = measure_scale();
+            return scale;
+        }
+        static nanos to_nanos(const cycles& c) noexcept { return nanos{ multiply(c, calibrate()) }; }
+
+    private:
+        // Nanoseconds per cycle in 32.32 fixed point
+        static std::uint64_t measure_scale() noexcept
+        {
+#if STRONG_HAS_RDTSC
+            using clock = std::chrono::steady_clock;
+            const auto start = clock::now();
+            const std::uint64_t first = now();
+            auto end = start;
+            while (end - start < std::chrono::milliseconds{ 10 }) end = clock::now();
+            const std::uint64_t elapsed = now_ordered() - first;
+            const auto ns = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            return elapsed ? (ns << 32) / elapsed : std::uint64_t{ 1 } << 32;
+#else
+            return std::uint64_t{ 1 } << 32;
+#endif
+        }
+        static std::uint64_t multiply(std::uint64_t value, std::uint64_t scale) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            return static_cast<std::uint64_t>((static_cast<unsigned __int128>(value) * scale) >> 32);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            std::uint64_t high;
+            const std::uint64_t low = _umul128(value, scale, &high);
+            return __shiftright128(low, high, 32);
+#else
+            return (value >> 32) * scale + (((value & 0xffffffffu) * (scale & 0xffffffffu)) >> 32) + (value & 0xffffffffu) * (scale >> 32);
+#endif
+        }
+    };
+}
+
+
+#ifdef STRONG_TSC_CLOCK_TEST
+ALIAS(Millis, std::uint64_t);
+
+int main()
+{
+    { strong::tsc_clock::calibrate(); }                                                      // ✔️
+    { strong::cycles start = strong::tsc_clock::now(); strong::cycles end = strong::tsc_clock::now_ordered(); strong::cycles c = end - start; } // ✔️
+    { strong::nanos n = strong::tsc_clock::to_nanos(strong::tsc_clock::now()); }             // ✔️
+    { strong::nanos n = strong::tsc_clock::now(); }                                           // ❌
+    { strong::cycles c = strong::tsc_clock::now(); c += strong::nanos{ 1u }; }                // ❌
+    { strong::tsc_clock::to_nanos(strong::nanos{ 1u }); }                                     // ❌
+    { Millis m = strong::tsc_clock::to_nanos(strong::tsc_clock::now()); }                     // ❌
+
+    return 0;
+}
+#endif